@@ -20,7 +20,71 @@
  
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+
+// Restrict qualifier for batch kernels (C99 keyword, compiler extension in C++)
+#ifndef GYROSPACE_RESTRICT
+    #if defined(__cplusplus) || defined(_MSC_VER)
+        #define GYROSPACE_RESTRICT __restrict
+    #else
+        #define GYROSPACE_RESTRICT restrict
+    #endif
+#endif
+
+// Alignment specifier for SIMD-friendly types
+#ifndef GYROSPACE_ALIGN
+    #if defined(_MSC_VER)
+        #define GYROSPACE_ALIGN(n) __declspec(align(n))
+    #else
+        #define GYROSPACE_ALIGN(n) __attribute__((aligned(n)))
+    #endif
+#endif
+
+/*
+ * Deterministic mode (define GYROSPACE_DETERMINISTIC) for replays and lockstep
+ * netcode: every build runs the same scalar code with FMA contraction off, and
+ * all trig goes through the polynomial GyroSpace_Fast* paths rather than the
+ * platform libm. sqrtf stays, as IEEE 754 requires it to be correctly rounded.
+ * Results are bit-identical across compilers and targets that evaluate float
+ * in float precision (SSE2/AArch64; not x87).
+ *
+ * Clang and MSVC have contraction switched off here by pragma. GCC ignores
+ * the standard pragma, and its optimize pragma stops these helpers from
+ * inlining, so with GCC build with -ffp-contract=off (already the default
+ * in the strict -std=c99/c11 modes, but not in the gnu modes or C++). GCC
+ * does not report that flag to the preprocessor, so on FMA-capable targets
+ * confirm it with -DGYROSPACE_FP_CONTRACT_OFF or the build stops here.
+ * tests/deterministic_check.sh compares output across such builds.
+ */
+#ifdef GYROSPACE_DETERMINISTIC
+    #include <float.h>
+    #if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+        #error "GYROSPACE_DETERMINISTIC cannot be combined with fast-math"
+    #endif
+    // 16 and 32 (_Float16/_Float32 evaluation, e.g. GCC with AVX512-FP16) still evaluate float as float
+    #if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 1 || FLT_EVAL_METHOD == 2 || FLT_EVAL_METHOD > 32)
+        #error "GYROSPACE_DETERMINISTIC requires float evaluation in float precision (use SSE2 on 32-bit x86)"
+    #endif
+    #if defined(__clang__)
+        #pragma STDC FP_CONTRACT OFF
+    #elif defined(_MSC_VER)
+        #pragma fp_contract(off)
+    #elif defined(__GNUC__) && (defined(__FP_FAST_FMA) || defined(__FP_FAST_FMAF) || defined(__FMA__)) && \
+          (defined(__cplusplus) || !defined(__STRICT_ANSI__)) && \
+          !defined(GYROSPACE_FP_CONTRACT_OFF) && !defined(__FP_CONTRACT_OFF)
+        #error "GYROSPACE_DETERMINISTIC with GCC on an FMA target needs -ffp-contract=off -DGYROSPACE_FP_CONTRACT_OFF"
+    #endif
+#endif
+
+// SSE is used for the Vector3A helpers when available (define GYROSPACE_NO_SIMD to disable)
+#if !defined(GYROSPACE_NO_SIMD) && !defined(GYROSPACE_DETERMINISTIC) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+    #define GYROSPACE_SSE 1
+    #include <xmmintrin.h>
+#else
+    #define GYROSPACE_SSE 0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -106,35 +170,687 @@ static inline Vector3 Vec3_Reflect(Vector3 v, Vector3 normal) {
     return Vec3_Subtract(v, Vec3_Scale(normal, 2.0f * Vec3_Dot(v, normal)));
 }
 
+// Aligned Vector Utilities
+
+/*
+ * 32-bit MSVC cannot pass 16-byte aligned structs by value (C2719), so
+ * there Vector3A keeps its 16-byte layout but not its alignment, and SSE
+ * code moves it with unaligned loads and stores.
+ */
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_IX86)
+    #define GYROSPACE_VEC3A_ALIGN
+    #define GYROSPACE_VEC3A_LOAD _mm_loadu_ps
+    #define GYROSPACE_VEC3A_STORE _mm_storeu_ps
+#else
+    #define GYROSPACE_VEC3A_ALIGN GYROSPACE_ALIGN(16)
+    #define GYROSPACE_VEC3A_LOAD _mm_load_ps
+    #define GYROSPACE_VEC3A_STORE _mm_store_ps
+#endif
+
+/**
+ * 16-byte aligned, padded vector with the same size and alignment as __m128.
+ * Arrays of Vector3A can be moved with one aligned SIMD load/store per
+ * element. w is padding and is kept at zero by every Vec3A_* helper.
+ */
+typedef struct GYROSPACE_VEC3A_ALIGN {
+    float x, y, z, w;
+} Vector3A;
+
+/** Creates a new Vector3A. */
+static inline Vector3A Vec3A_New(float x, float y, float z) {
+    Vector3A result = { x, y, z, 0.0f };
+    return result;
+}
+
+/** Widens a Vector3 to a Vector3A. */
+static inline Vector3A Vec3A_FromVec3(Vector3 v) {
+    return Vec3A_New(v.x, v.y, v.z);
+}
+
+/** Narrows a Vector3A to a Vector3. */
+static inline Vector3 Vec3A_ToVec3(Vector3A v) {
+    return Vec3_New(v.x, v.y, v.z);
+}
+
+#if GYROSPACE_SSE
+
+/** Loads a Vector3A into an SSE register. */
+static inline __m128 Vec3A_Load(const Vector3A* v) {
+    return GYROSPACE_VEC3A_LOAD(&v->x);
+}
+
+/** Stores an SSE register into a Vector3A. */
+static inline Vector3A Vec3A_FromM128(__m128 v) {
+    Vector3A result;
+    GYROSPACE_VEC3A_STORE(&result.x, v);
+    return result;
+}
+
+/** Horizontal sum of the x, y and z lanes, broadcast into lane 0. */
+static inline __m128 Vec3A_HorizontalSum3(__m128 v) {
+    __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    return _mm_add_ss(_mm_add_ss(v, y), z);
+}
+
+#endif
+
+/** Adds two vectors. */
+static inline Vector3A Vec3A_Add(Vector3A a, Vector3A b) {
+#if GYROSPACE_SSE
+    return Vec3A_FromM128(_mm_add_ps(Vec3A_Load(&a), Vec3A_Load(&b)));
+#else
+    return Vec3A_New(a.x + b.x, a.y + b.y, a.z + b.z);
+#endif
+}
+
+/** Subtracts vector b from vector a. */
+static inline Vector3A Vec3A_Subtract(Vector3A a, Vector3A b) {
+#if GYROSPACE_SSE
+    return Vec3A_FromM128(_mm_sub_ps(Vec3A_Load(&a), Vec3A_Load(&b)));
+#else
+    return Vec3A_New(a.x - b.x, a.y - b.y, a.z - b.z);
+#endif
+}
+
+/** Scales vector v by scalar. */
+static inline Vector3A Vec3A_Scale(Vector3A v, float scalar) {
+#if GYROSPACE_SSE
+    return Vec3A_FromM128(_mm_mul_ps(Vec3A_Load(&v), _mm_set1_ps(scalar)));
+#else
+    return Vec3A_New(v.x * scalar, v.y * scalar, v.z * scalar);
+#endif
+}
+
+/** Returns the dot product of two vectors. */
+static inline float Vec3A_Dot(Vector3A a, Vector3A b) {
+#if GYROSPACE_SSE
+    return _mm_cvtss_f32(Vec3A_HorizontalSum3(_mm_mul_ps(Vec3A_Load(&a), Vec3A_Load(&b))));
+#else
+    return a.x*b.x + a.y*b.y + a.z*b.z;
+#endif
+}
+
+/** Returns the cross product of two vectors. */
+static inline Vector3A Vec3A_Cross(Vector3A a, Vector3A b) {
+#if GYROSPACE_SSE
+    __m128 va = Vec3A_Load(&a);
+    __m128 vb = Vec3A_Load(&b);
+    __m128 aYZX = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(va, bYZX), _mm_mul_ps(aYZX, vb));
+    return Vec3A_FromM128(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+#else
+    return Vec3A_New(
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    );
+#endif
+}
+
+/** Returns the magnitude of a vector. */
+static inline float Vec3A_Magnitude(Vector3A v) {
+#if GYROSPACE_SSE
+    __m128 vv = Vec3A_Load(&v);
+    return _mm_cvtss_f32(_mm_sqrt_ss(Vec3A_HorizontalSum3(_mm_mul_ps(vv, vv))));
+#else
+    return sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
+#endif
+}
+
+/** Normalizes a vector to unit length. Returns (0,0,0) if length is negligible. */
+static inline Vector3A Vec3A_Normalize(Vector3A v) {
+    float len = Vec3A_Magnitude(v);
+    if (len < EPSILON) return Vec3A_New(0.0f, 0.0f, 0.0f);
+    return Vec3A_Scale(v, 1.0f / len);
+}
+
+/** Checks if a vector is near zero. */
+static inline bool Vec3A_IsZero(Vector3A v) {
+    return (fabsf(v.x) < EPSILON && fabsf(v.y) < EPSILON && fabsf(v.z) < EPSILON);
+}
+
+/** Linearly interpolates between two vectors. */
+static inline Vector3A Vec3A_Lerp(Vector3A a, Vector3A b, float t) {
+    t = clamp(t, 0.0f, 1.0f);
+    return Vec3A_Add(a, Vec3A_Scale(Vec3A_Subtract(b, a), t));
+}
+
+// Fast Math
+
+/**
+ * Float approximations of the trig functions needed for orientation
+ * extraction, recentering and flick stick, so per-sample code does not pay
+ * for libm. Each has a scalar form, a four-lane SSE form (suffix _4) and a
+ * batch form over arrays. Listed errors are absolute, measured against
+ * double-precision libm by tests/fast_trig.c.
+ *
+ *   atan2    1.2e-5 rad
+ *   asin     3e-7 rad, input clamped to [-1, 1]
+ *   acos     5e-7 rad, input clamped to [-1, 1]
+ *   sin/cos  1e-7 for |x| <= 8192 rad
+ */
+
+#define GYROSPACE_PI 3.14159265358979f
+#define GYROSPACE_RAD_TO_DEG (180.0f / GYROSPACE_PI)
+
+// Three-part pi/2 for Cody-Waite range reduction of sin/cos
+#define GYROSPACE_PIO2_HI 1.5703125f
+#define GYROSPACE_PIO2_MID 4.837512969970703125e-4f
+#define GYROSPACE_PIO2_LO 7.54978995489188216e-8f
+
+/** Core atan polynomial on [0, 1] (Abramowitz & Stegun 4.4.49). */
+#define GYROSPACE_ATAN_POLY(a, s) \
+    (((((0.0208351f * (s) - 0.0851330f) * (s) + 0.1801410f) * (s) - 0.3302995f) * (s) + 0.9998660f) * (a))
+
+/** Core acos polynomial on [0, 1]: acos(x) = sqrt(1 - x) * P(x) (Abramowitz & Stegun 4.4.46). */
+#define GYROSPACE_ACOS_POLY(x) \
+    (((((((-0.0012624911f * (x) + 0.0066700901f) * (x) - 0.0170881256f) * (x) + 0.0308918810f) * (x) \
+        - 0.0501743046f) * (x) + 0.0889789874f) * (x) - 0.2145988016f) * (x) + 1.5707963050f)
+
+/**
+ * Polynomial atan2 approximation. atan2(0, 0) returns 0. The octant is
+ * resolved with selects rather than nested branches.
+ */
+static inline float GyroSpace_FastAtan2(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = fmaxf(ax, ay), mn = fminf(ax, ay);
+    float a = (mx > 0.0f) ? mn / mx : 0.0f;
+    float s = a * a;
+    float r = GYROSPACE_ATAN_POLY(a, s);
+    r = (ay > ax) ? (GYROSPACE_PI * 0.5f) - r : r;
+    r = (x < 0.0f) ? GYROSPACE_PI - r : r;
+    return (y < 0.0f) ? -r : r;
+}
+
+/** Polynomial acos approximation. */
+static inline float GyroSpace_FastAcos(float x) {
+    x = clamp(x, -1.0f, 1.0f);
+    float ax = fabsf(x);
+    float r = sqrtf(1.0f - ax) * GYROSPACE_ACOS_POLY(ax);
+    return (x < 0.0f) ? GYROSPACE_PI - r : r;
+}
+
+/** Polynomial asin approximation. */
+static inline float GyroSpace_FastAsin(float x) {
+    x = clamp(x, -1.0f, 1.0f);
+    float ax = fabsf(x);
+    float r = (GYROSPACE_PI * 0.5f) - sqrtf(1.0f - ax) * GYROSPACE_ACOS_POLY(ax);
+    return (x < 0.0f) ? -r : r;
+}
+
+/** Computes sin and cos of x together, sharing the range reduction. */
+static inline void GyroSpace_FastSinCos(float x, float* outSin, float* outCos) {
+    // Reduce to r in [-pi/4, pi/4] and quadrant q
+    float q = rintf(x * (2.0f / GYROSPACE_PI));
+    float r = ((x - q * GYROSPACE_PIO2_HI) - q * GYROSPACE_PIO2_MID) - q * GYROSPACE_PIO2_LO;
+    float r2 = r * r;
+
+    float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    int quadrant = (int)(q - 4.0f * floorf(q * 0.25f));
+    float sinR = (quadrant & 1) ? c : s;
+    float cosR = (quadrant & 1) ? s : c;
+    *outSin = (quadrant & 2) ? -sinR : sinR;
+    *outCos = ((quadrant + 1) & 2) ? -cosR : cosR;
+}
+
+#if GYROSPACE_SSE
+
+/** Lane-wise mask ? a : b. */
+static inline __m128 GyroSpace_Select_4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/** Lane-wise absolute value. */
+static inline __m128 GyroSpace_Abs_4(__m128 x) {
+    return _mm_max_ps(x, _mm_sub_ps(_mm_setzero_ps(), x));
+}
+
+/** Lane-wise round to nearest integer (|x| < 2^22), without SSE2/SSE4.1. */
+static inline __m128 GyroSpace_Round_4(__m128 x) {
+    const __m128 magic = _mm_set1_ps(12582912.0f); // 1.5 * 2^23
+    return _mm_sub_ps(_mm_add_ps(x, magic), magic);
+}
+
+/** Four-lane GyroSpace_FastAtan2. */
+static inline __m128 GyroSpace_FastAtan2_4(__m128 y, __m128 x) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 ax = GyroSpace_Abs_4(x), ay = GyroSpace_Abs_4(y);
+    __m128 mx = _mm_max_ps(ax, ay), mn = _mm_min_ps(ax, ay);
+    __m128 a = _mm_and_ps(_mm_cmpgt_ps(mx, zero), _mm_div_ps(mn, mx));
+    __m128 s = _mm_mul_ps(a, a);
+
+    __m128 r = _mm_set1_ps(0.0208351f);
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.0851330f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1801410f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.3302995f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.9998660f));
+    r = _mm_mul_ps(r, a);
+
+    r = GyroSpace_Select_4(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(GYROSPACE_PI * 0.5f), r), r);
+    r = GyroSpace_Select_4(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(GYROSPACE_PI), r), r);
+    return GyroSpace_Select_4(_mm_cmplt_ps(y, zero), _mm_sub_ps(zero, r), r);
+}
+
+/** acos of |x| without the sign fix-up; shared by the four-lane asin and acos. */
+static inline __m128 GyroSpace_AcosAbs_4(__m128 ax) {
+    __m128 p = _mm_set1_ps(-0.0012624911f);
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(0.0066700901f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(-0.0170881256f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(0.0308918810f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(-0.0501743046f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(0.0889789874f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(-0.2145988016f));
+    p = _mm_add_ps(_mm_mul_ps(p, ax), _mm_set1_ps(1.5707963050f));
+    return _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), p);
+}
+
+/** Four-lane GyroSpace_FastAcos. */
+static inline __m128 GyroSpace_FastAcos_4(__m128 x) {
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    __m128 r = GyroSpace_AcosAbs_4(GyroSpace_Abs_4(x));
+    return GyroSpace_Select_4(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(GYROSPACE_PI), r), r);
+}
+
+/** Four-lane GyroSpace_FastAsin. */
+static inline __m128 GyroSpace_FastAsin_4(__m128 x) {
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    __m128 r = _mm_sub_ps(_mm_set1_ps(GYROSPACE_PI * 0.5f), GyroSpace_AcosAbs_4(GyroSpace_Abs_4(x)));
+    return GyroSpace_Select_4(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_setzero_ps(), r), r);
+}
+
+/** Four-lane GyroSpace_FastSinCos. */
+static inline void GyroSpace_FastSinCos_4(__m128 x, __m128* outSin, __m128* outCos) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    __m128 q = GyroSpace_Round_4(_mm_mul_ps(x, _mm_set1_ps(2.0f / GYROSPACE_PI)));
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(GYROSPACE_PIO2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(GYROSPACE_PIO2_MID)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(GYROSPACE_PIO2_LO)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 sp = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)), _mm_set1_ps(8.3321608736e-3f));
+    sp = _mm_add_ps(_mm_mul_ps(sp, r2), _mm_set1_ps(-1.6666654611e-1f));
+    __m128 s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sp));
+
+    __m128 cp = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)), _mm_set1_ps(-1.388731625493765e-3f));
+    cp = _mm_add_ps(_mm_mul_ps(cp, r2), _mm_set1_ps(4.166664568298827e-2f));
+    __m128 c = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), cp));
+
+    // Quadrant = q mod 4, computed in float to stay within SSE1
+    __m128 quadrant = _mm_sub_ps(q, _mm_mul_ps(_mm_set1_ps(4.0f), GyroSpace_Round_4(_mm_sub_ps(_mm_mul_ps(q, _mm_set1_ps(0.25f)), _mm_set1_ps(0.375f)))));
+    __m128 odd = _mm_or_ps(_mm_cmpeq_ps(quadrant, one), _mm_cmpeq_ps(quadrant, _mm_set1_ps(3.0f)));
+    __m128 negSin = _mm_cmpge_ps(quadrant, _mm_set1_ps(2.0f));
+    __m128 negCos = _mm_or_ps(_mm_cmpeq_ps(quadrant, one), _mm_cmpeq_ps(quadrant, _mm_set1_ps(2.0f)));
+
+    __m128 sinR = GyroSpace_Select_4(odd, c, s);
+    __m128 cosR = GyroSpace_Select_4(odd, s, c);
+    *outSin = GyroSpace_Select_4(negSin, _mm_sub_ps(zero, sinR), sinR);
+    *outCos = GyroSpace_Select_4(negCos, _mm_sub_ps(zero, cosR), cosR);
+}
+
+#endif
+
+/** Computes out[i] = atan2(y[i], x[i]) for count values. */
+static inline void GyroSpace_FastAtan2Batch(const float* y, const float* x, float* out, size_t count) {
+    size_t i = 0;
+#if GYROSPACE_SSE
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, GyroSpace_FastAtan2_4(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+#endif
+    for (; i < count; ++i)
+        out[i] = GyroSpace_FastAtan2(y[i], x[i]);
+}
+
+/** Computes out[i] = asin(x[i]) for count values. */
+static inline void GyroSpace_FastAsinBatch(const float* x, float* out, size_t count) {
+    size_t i = 0;
+#if GYROSPACE_SSE
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, GyroSpace_FastAsin_4(_mm_loadu_ps(x + i)));
+#endif
+    for (; i < count; ++i)
+        out[i] = GyroSpace_FastAsin(x[i]);
+}
+
+/** Computes out[i] = acos(x[i]) for count values. */
+static inline void GyroSpace_FastAcosBatch(const float* x, float* out, size_t count) {
+    size_t i = 0;
+#if GYROSPACE_SSE
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, GyroSpace_FastAcos_4(_mm_loadu_ps(x + i)));
+#endif
+    for (; i < count; ++i)
+        out[i] = GyroSpace_FastAcos(x[i]);
+}
+
+/** Computes sin and cos of count values. */
+static inline void GyroSpace_FastSinCosBatch(const float* x, float* outSin, float* outCos, size_t count) {
+    size_t i = 0;
+#if GYROSPACE_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 s, c;
+        GyroSpace_FastSinCos_4(_mm_loadu_ps(x + i), &s, &c);
+        _mm_storeu_ps(outSin + i, s);
+        _mm_storeu_ps(outCos + i, c);
+    }
+#endif
+    for (; i < count; ++i)
+        GyroSpace_FastSinCos(x[i], &outSin[i], &outCos[i]);
+}
+
+/** Wraps an angle in radians to [-pi, pi]. */
+static inline float GyroSpace_WrapAngle(float radians) {
+    return radians - (2.0f * GYROSPACE_PI) * floorf((radians + GYROSPACE_PI) * (0.5f / GYROSPACE_PI));
+}
+
+// Matrix Utilities
+
+/** Row-major 3x3 matrix; m[row][col]. Multiplies column vectors (M * v). */
+typedef struct {
+    float m[3][3];
+} Mat3;
+
+/** Returns the identity matrix. */
+static inline Mat3 Mat3_Identity(void) {
+    Mat3 result = { { { 1.0f, 0.0f, 0.0f },
+                      { 0.0f, 1.0f, 0.0f },
+                      { 0.0f, 0.0f, 1.0f } } };
+    return result;
+}
+
+/** Builds a matrix from three row vectors. */
+static inline Mat3 Mat3_FromRows(Vector3 r0, Vector3 r1, Vector3 r2) {
+    Mat3 result = { { { r0.x, r0.y, r0.z },
+                      { r1.x, r1.y, r1.z },
+                      { r2.x, r2.y, r2.z } } };
+    return result;
+}
+
+/** Returns row i (0..2) of the matrix as a vector. */
+static inline Vector3 Mat3_Row(const Mat3* m, int i) {
+    return Vec3_New(m->m[i][0], m->m[i][1], m->m[i][2]);
+}
+
+/** Returns the transpose of a matrix. For a rotation this is also its inverse. */
+static inline Mat3 Mat3_Transpose(Mat3 a) {
+    Mat3 result;
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            result.m[r][c] = a.m[c][r];
+    return result;
+}
+
+/** Returns the matrix product a * b (b is applied first). */
+static inline Mat3 Mat3_Multiply(Mat3 a, Mat3 b) {
+    Mat3 result;
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            result.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c] + a.m[r][2] * b.m[2][c];
+    return result;
+}
+
+/** Returns m * v. */
+static inline Vector3 Mat3_MulVec3(const Mat3* m, Vector3 v) {
+    return Vec3_New(
+        m->m[0][0] * v.x + m->m[0][1] * v.y + m->m[0][2] * v.z,
+        m->m[1][0] * v.x + m->m[1][1] * v.y + m->m[1][2] * v.z,
+        m->m[2][0] * v.x + m->m[2][1] * v.y + m->m[2][2] * v.z
+    );
+}
+
+/**
+ * Multiplies count column vectors stored as separate x/y/z arrays (SoA) by m.
+ * Output arrays must not alias the inputs. Written as a flat loop so that
+ * compilers vectorize it across samples.
+ */
+static inline void Mat3_MulVec3Batch(const Mat3* m,
+                                     const float* GYROSPACE_RESTRICT inX,
+                                     const float* GYROSPACE_RESTRICT inY,
+                                     const float* GYROSPACE_RESTRICT inZ,
+                                     float* GYROSPACE_RESTRICT outX,
+                                     float* GYROSPACE_RESTRICT outY,
+                                     float* GYROSPACE_RESTRICT outZ,
+                                     size_t count) {
+    const float m00 = m->m[0][0], m01 = m->m[0][1], m02 = m->m[0][2];
+    const float m10 = m->m[1][0], m11 = m->m[1][1], m12 = m->m[1][2];
+    const float m20 = m->m[2][0], m21 = m->m[2][1], m22 = m->m[2][2];
+
+    for (size_t i = 0; i < count; ++i) {
+        const float x = inX[i], y = inY[i], z = inZ[i];
+        outX[i] = m00 * x + m01 * y + m02 * z;
+        outY[i] = m10 * x + m11 * y + m12 * z;
+        outZ[i] = m20 * x + m21 * y + m22 * z;
+    }
+}
+
+/**
+ * Multiplies count packed (x, y, z) float triplets by m and writes the result
+ * as SoA arrays. xyz can be a float[count][3] array of raw sensor reports or
+ * a Vector3 array (pass &v[0].x). The AoS-to-SoA transpose is done with
+ * shuffles inside the kernel, four samples at a time, so no intermediate
+ * SoA copy is needed.
+ */
+static inline void Mat3_MulVec3InterleavedBatch(const Mat3* m,
+                                                const float* GYROSPACE_RESTRICT xyz,
+                                                float* GYROSPACE_RESTRICT outX,
+                                                float* GYROSPACE_RESTRICT outY,
+                                                float* GYROSPACE_RESTRICT outZ,
+                                                size_t count) {
+    const float m00 = m->m[0][0], m01 = m->m[0][1], m02 = m->m[0][2];
+    const float m10 = m->m[1][0], m11 = m->m[1][1], m12 = m->m[1][2];
+    const float m20 = m->m[2][0], m21 = m->m[2][1], m22 = m->m[2][2];
+    size_t i = 0;
+
+#if GYROSPACE_SSE
+    for (const size_t simdCount = count & ~(size_t)3; i < simdCount; i += 4) {
+        __m128 a = _mm_loadu_ps(xyz + 3 * i);       // x0 y0 z0 x1
+        __m128 b = _mm_loadu_ps(xyz + 3 * i + 4);   // y1 z1 x2 y2
+        __m128 c = _mm_loadu_ps(xyz + 3 * i + 8);   // z2 x3 y3 z3
+
+        __m128 x = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 3, 0)),
+                                  _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+        __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)),
+                                  _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                  _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m00), x), _mm_mul_ps(_mm_set1_ps(m01), y)), _mm_mul_ps(_mm_set1_ps(m02), z)));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m10), x), _mm_mul_ps(_mm_set1_ps(m11), y)), _mm_mul_ps(_mm_set1_ps(m12), z)));
+        _mm_storeu_ps(outZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m20), x), _mm_mul_ps(_mm_set1_ps(m21), y)), _mm_mul_ps(_mm_set1_ps(m22), z)));
+    }
+#endif
+    for (; i < count; ++i) {
+        const float x = xyz[3 * i], y = xyz[3 * i + 1], z = xyz[3 * i + 2];
+        outX[i] = m00 * x + m01 * y + m02 * z;
+        outY[i] = m10 * x + m11 * y + m12 * z;
+        outZ[i] = m20 * x + m21 * y + m22 * z;
+    }
+}
+
+/** Multiplies count packed Vector3 values (AoS) by m. in and out may be the same array. */
+static inline void Mat3_MulVec3ArrayBatch(const Mat3* m, const Vector3* in, Vector3* out, size_t count) {
+    const Mat3 local = *m;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = Mat3_MulVec3(&local, in[i]);
+}
+
+/** Returns m * v for an aligned vector. */
+static inline Vector3A Mat3_MulVec3A(const Mat3* m, Vector3A v) {
+#if GYROSPACE_SSE
+    __m128 vv = Vec3A_Load(&v);
+    __m128 r = _mm_mul_ps(_mm_set1_ps(v.x), _mm_setr_ps(m->m[0][0], m->m[1][0], m->m[2][0], 0.0f));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(vv, vv, _MM_SHUFFLE(1, 1, 1, 1)),
+                                 _mm_setr_ps(m->m[0][1], m->m[1][1], m->m[2][1], 0.0f)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(vv, vv, _MM_SHUFFLE(2, 2, 2, 2)),
+                                 _mm_setr_ps(m->m[0][2], m->m[1][2], m->m[2][2], 0.0f)));
+    return Vec3A_FromM128(r);
+#else
+    return Vec3A_FromVec3(Mat3_MulVec3(m, Vec3A_ToVec3(v)));
+#endif
+}
+
+/**
+ * Multiplies count aligned vectors (AoS) by m; in and out may be the same array.
+ * Each element is one aligned load and one aligned store when SSE is enabled.
+ */
+static inline void Mat3_MulVec3ABatch(const Mat3* m, const Vector3A* in, Vector3A* out, size_t count) {
+#if GYROSPACE_SSE
+    const __m128 c0 = _mm_setr_ps(m->m[0][0], m->m[1][0], m->m[2][0], 0.0f);
+    const __m128 c1 = _mm_setr_ps(m->m[0][1], m->m[1][1], m->m[2][1], 0.0f);
+    const __m128 c2 = _mm_setr_ps(m->m[0][2], m->m[1][2], m->m[2][2], 0.0f);
+
+    for (size_t i = 0; i < count; ++i) {
+        __m128 v = GYROSPACE_VEC3A_LOAD(&in[i].x);
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), c0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), c1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), c2));
+        GYROSPACE_VEC3A_STORE(&out[i].x, r);
+    }
+#else
+    const Mat3 local = *m;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = Mat3_MulVec3A(&local, in[i]);
+#endif
+}
+
 // Global Gravity Vector Management
 
 /** Global gravity vector (default: (0, 1, 0)). */
 static Vector3 gravNorm = { 0.0f, 1.0f, 0.0f };
 
-/** Sets the global gravity vector manually (should be called with raw accel data). */
-static inline void SetGravityVector(float x, float y, float z) {
-    if (isnan(x) || isnan(y) || isnan(z))
-        return;
+/**
+ * Validates raw accel data and writes the normalized gravity vector to out.
+ * Returns false (leaving out untouched) for a non-finite or zero-length
+ * vector. Any other direction is accepted as-is, including (0, 0, 1),
+ * which integer accel normalizes to exactly when a device sits upright.
+ */
+static inline bool GyroSpace_ResolveGravity(float x, float y, float z, Vector3* out) {
+    if (!isfinite(x) || !isfinite(y) || !isfinite(z))
+        return false;
 
     Vector3 newGrav = Vec3_New(x, y, z);
     if (Vec3_Magnitude(newGrav) < EPSILON)
+        return false;
+
+    *out = Vec3_Normalize(newGrav);
+    return true;
+}
+
+/** Sets the global gravity vector manually (should be called with raw accel data). */
+static inline void SetGravityVector(float x, float y, float z) {
+    Vector3 newGrav;
+    if (!GyroSpace_ResolveGravity(x, y, z, &newGrav))
         return;
 
     // Prevent gravity from being exactly (0,0,1) unless explicitly allowed
-    if (fabsf(newGrav.x) < EPSILON && fabsf(newGrav.y) < EPSILON && fabsf(newGrav.z - 1.0f) < EPSILON) {
+    if (fabsf(x) < EPSILON && fabsf(y) < EPSILON && fabsf(z - 1.0f) < EPSILON) {
         // Fallback to Y-up
-        gravNorm = Vec3_New(0.0f, 1.0f, 0.0f);
-        return;
+        newGrav = Vec3_New(0.0f, 1.0f, 0.0f);
+    }
+
+    gravNorm = newGrav;
+}
+
+/**
+ * How a gravity estimate follows the accelerometer:
+ * RAW takes each accel sample as gravity (cheapest, noisiest),
+ * LOWPASS blends toward each sample by a fixed factor,
+ * FUSED rotates the previous estimate by the gyro and then blends toward
+ * the accel sample, so it tracks turns without following linear motion.
+ */
+typedef enum {
+    GYROSPACE_GRAVITY_RAW = 0,
+    GYROSPACE_GRAVITY_LOWPASS = 1,
+    GYROSPACE_GRAVITY_FUSED = 2
+} GyroSpaceGravityPolicy;
+
+/*
+ * Define GYROSPACE_GRAVITY_POLICY to one of the values above to fix the
+ * policy at compile time for UpdateGravityVector and every context; the
+ * policy switch then folds away. Without it, UpdateGravityVector stays raw
+ * and contexts choose at runtime.
+ */
+
+/** Rotates a gravity vector (sensor frame) against a gyro rate in degrees per second over deltaTime. */
+static inline Vector3 GyroSpace_RotateGravity(Vector3 gravity, Vector3 gyroRotation, float deltaTime) {
+    float rate = Vec3_Magnitude(gyroRotation);
+    if (rate < EPSILON)
+        return gravity;
+
+    // Rodrigues rotation by -angle about the gyro axis
+    Vector3 axis = Vec3_Scale(gyroRotation, 1.0f / rate);
+    float s, c;
+    GyroSpace_FastSinCos(-rate * deltaTime * (GYROSPACE_PI / 180.0f), &s, &c);
+    Vector3 rotated = Vec3_Add(Vec3_Scale(gravity, c), Vec3_Scale(Vec3_Cross(axis, gravity), s));
+    return Vec3_Add(rotated, Vec3_Scale(axis, Vec3_Dot(axis, gravity) * (1.0f - c)));
+}
+
+/** LOWPASS step: moves the estimate toward the normalized accel sample by fusionFactor (0..1). */
+static inline Vector3 GyroSpace_GravityLowPass(Vector3 gravity, Vector3 accelNorm, float fusionFactor) {
+    return Vec3_Lerp(gravity, accelNorm, fusionFactor);
+}
+
+/** FUSED step: integrates the gyro into the estimate, then corrects toward the accel sample by fusionFactor. */
+static inline Vector3 GyroSpace_GravityFused(Vector3 gravity, Vector3 accelNorm, Vector3 gyroRotation,
+                                             float fusionFactor, float deltaTime) {
+    return Vec3_Lerp(GyroSpace_RotateGravity(gravity, gyroRotation, deltaTime), accelNorm, fusionFactor);
+}
+
+/**
+ * Advances a gravity estimate by one accel/gyro sample under the given
+ * policy. Returns false (leaving gravity untouched) if the sample is
+ * ignored. With a constant policy only that path is compiled in.
+ */
+static inline bool GyroSpace_ApplyGravityPolicy(GyroSpaceGravityPolicy policy, Vector3* gravity,
+                                                Vector3 accel, Vector3 gyroRotation,
+                                                float fusionFactor, float deltaTime) {
+    Vector3 accelNorm;
+    if (!GyroSpace_ResolveGravity(accel.x, accel.y, accel.z, &accelNorm))
+        return false;
+
+    switch (policy) {
+    case GYROSPACE_GRAVITY_LOWPASS:
+        accelNorm = GyroSpace_GravityLowPass(*gravity, accelNorm, fusionFactor);
+        break;
+    case GYROSPACE_GRAVITY_FUSED:
+        accelNorm = GyroSpace_GravityFused(*gravity, accelNorm, gyroRotation, fusionFactor, deltaTime);
+        break;
+    default:
+        *gravity = accelNorm;
+        return true;
     }
+    return GyroSpace_ResolveGravity(accelNorm.x, accelNorm.y, accelNorm.z, gravity);
+}
 
-    gravNorm = Vec3_Normalize(newGrav);
+/**
+ * Shake rejection test: returns true if |accel|^2 lies within
+ * [minSquared, maxSquared], i.e. the sample is plausibly gravity alone.
+ * Compares squared magnitudes so no sqrtf is needed; NaN input fails.
+ */
+static inline bool GyroSpace_AccelInGravityBand(Vector3 accel, float minSquared, float maxSquared) {
+    float magSquared = Vec3_Dot(accel, accel);
+    return magSquared >= minSquared && magSquared <= maxSquared;
 }
 
 /**
- * Updates the global gravity vector using the raw accelerometer vector.
- * This is a generic approach for all input APIs.
+ * Updates the global gravity vector from an accel sample and the gyro
+ * rotation (degrees per second, sensor axes) over deltaTime.
+ * Uses the raw accelerometer vector unless GYROSPACE_GRAVITY_POLICY is
+ * defined; fusionFactor is the per-sample weight of the accel sample.
  */
 static inline void UpdateGravityVector(Vector3 accel, Vector3 gyroRotation, float fusionFactor, float deltaTime) {
+#ifdef GYROSPACE_GRAVITY_POLICY
+    // RAW keeps SetGravityVector's handling, including the Y-up fallback
+    if (GYROSPACE_GRAVITY_POLICY != GYROSPACE_GRAVITY_RAW) {
+        GyroSpace_ApplyGravityPolicy(GYROSPACE_GRAVITY_POLICY, &gravNorm, accel, gyroRotation, fusionFactor, deltaTime);
+        return;
+    }
+#endif
     // Use only the raw accelerometer vector for gravity
     SetGravityVector(accel.x, accel.y, accel.z);
 }
@@ -144,6 +860,33 @@ static inline Vector3 GetGravityVector(void) {
     return gravNorm;
 }
  
+// World Space Basis
+
+/**
+ * Builds the World Space matrix for a gravity vector.
+ *
+ * The rows are the world right, up (gravity) and projected forward axes, in
+ * that order, so multiplying a (yaw, pitch, roll) gyro vector by the result
+ * gives the World Space output as (pitch, yaw, roll) for typical FPS/game
+ * engines. The matrix is orthonormal, so its transpose maps back to sensor
+ * space.
+ */
+static inline Mat3 GyroSpace_BuildWorldMatrix(Vector3 gravity) {
+    gravity = Vec3_Normalize(gravity);
+
+    // World axes
+    Vector3 worldFwd = Vec3_New(0.0f, 0.0f, 1.0f); // Z+
+    if (fabsf(Vec3_Dot(gravity, worldFwd)) > 0.99f) {
+        worldFwd = Vec3_New(1.0f, 0.0f, 0.0f); // X+ fallback
+    }
+
+    Vector3 worldRight = Vec3_Normalize(Vec3_Cross(gravity, worldFwd));
+    Vector3 worldFwdProj = Vec3_Normalize(Vec3_Cross(worldRight, gravity));
+
+    // Rows: pitch (right), yaw (up), roll (forward)
+    return Mat3_FromRows(worldRight, gravity, worldFwdProj);
+}
+
  // Gyro Space Transformation Function
  
  /**
@@ -151,6 +894,16 @@ static inline Vector3 GetGravityVector(void) {
   * while handling sensitivity adjustments and gravity alignment.
   */
 
+/**
+ * The transform spaces. Local and Player Space output (yaw, pitch, roll);
+ * World Space outputs (pitch, yaw, roll).
+ */
+typedef enum {
+    GYROSPACE_SPACE_LOCAL = 0,
+    GYROSPACE_SPACE_PLAYER = 1,
+    GYROSPACE_SPACE_WORLD = 2
+} GyroSpaceTransformSpace;
+
 /* Transforms gyro inputs to Local Space.
  *
  * Converts raw gyro input into direct motion scaling.
@@ -167,13 +920,14 @@ static inline Vector3 TransformToLocalSpace(float yaw, float pitch, float roll,
 }
  
 /**
- * Transforms gyro inputs to Player Space.
- * Adjusts motion relative to the player's perspective while ensuring gravity alignment.
+ * Player Space against a given normalized gravity vector. Shared by
+ * TransformToPlayerSpace (global gravity) and GyroSpace_TransformToPlayerSpace
+ * (per-context gravity).
  */
-static inline Vector3 TransformToPlayerSpace(float yaw, float pitch, float roll) {
+static inline Vector3 GyroSpace_PlayerSpaceForGravity(Vector3 gravity, float yaw, float pitch, float roll) {
 
     //  Player space yaw: combine yaw and roll, use gravity for direction 
-    float worldYaw = yaw * gravNorm.y + roll * gravNorm.z;
+    float worldYaw = yaw * gravity.y + roll * gravity.z;
 
     //  Yaw relaxation: buffer zone for local aiming freedom 
     float yawRelaxFactor = 2.0f; // 1.41f for ~45°, 2.0f for ~60° buffer
@@ -187,36 +941,1770 @@ static inline Vector3 TransformToPlayerSpace(float yaw, float pitch, float roll)
     Vector3 playerGyro = Vec3_New(adjustedYaw, adjustedPitch, 0);
     return playerGyro;
 }
+
+/**
+ * Transforms gyro inputs to Player Space.
+ * Adjusts motion relative to the player's perspective while ensuring gravity alignment.
+ */
+static inline Vector3 TransformToPlayerSpace(float yaw, float pitch, float roll) {
+    return GyroSpace_PlayerSpaceForGravity(gravNorm, yaw, pitch, roll);
+}
  
 /**
  * Transforms gyro inputs to World Space.
  * Aligns input with the game world while maintaining spatial consistency.
  */
 static inline Vector3 TransformToWorldSpace(float yaw, float pitch, float roll) {
-    Vector3 gyro = Vec3_New(yaw, pitch, roll);
-    Vector3 gravity = GetGravityVector();
-    gravity = Vec3_Normalize(gravity);
+    Mat3 world = GyroSpace_BuildWorldMatrix(GetGravityVector());
+    return Mat3_MulVec3(&world, Vec3_New(yaw, pitch, roll));
+}
 
-    // World axes
-    Vector3 worldFwd = Vec3_New(0.0f, 0.0f, 1.0f); // Z+
-    if (fabsf(Vec3_Dot(gravity, worldFwd)) > 0.99f) {
-        worldFwd = Vec3_New(1.0f, 0.0f, 0.0f); // X+ fallback
+// Dynamic Orientation
+
+/**
+ * Device postures, classified by which sensor axis gravity is closest to.
+ * Landscape and portrait are the two upright (screen facing the player)
+ * postures of a handheld; flat covers a gamepad held normally or a device
+ * lying on a table.
+ */
+typedef enum {
+    GYROSPACE_POSTURE_FLAT = 0,      // Gravity along sensor Y
+    GYROSPACE_POSTURE_LANDSCAPE = 1, // Gravity along sensor Z (upright, wide)
+    GYROSPACE_POSTURE_PORTRAIT = 2   // Gravity along sensor X (upright, tall)
+} GyroSpacePosture;
+
+/** Default margin (in normalized gravity units) a new axis must win by before the posture changes. */
+#ifndef GYROSPACE_POSTURE_HYSTERESIS
+    #define GYROSPACE_POSTURE_HYSTERESIS 0.2f
+#endif
+
+/**
+ * Builds the matrix that maps raw sensor gyro (x, y, z) to (yaw, pitch, roll)
+ * for a posture. sign is the sign of gravity along the posture's axis.
+ *
+ * For a flat, face-up device this is the usual (y, x, z) selection from the
+ * README; the other postures rotate it so yaw always follows the axis
+ * closest to gravity.
+ */
+static inline Mat3 GyroSpace_BuildAxisMatrix(GyroSpacePosture posture, float sign) {
+    switch (posture) {
+    case GYROSPACE_POSTURE_LANDSCAPE:
+        return Mat3_FromRows(Vec3_New(0.0f, 0.0f, sign), Vec3_New(1.0f, 0.0f, 0.0f), Vec3_New(0.0f, -sign, 0.0f));
+    case GYROSPACE_POSTURE_PORTRAIT:
+        return Mat3_FromRows(Vec3_New(sign, 0.0f, 0.0f), Vec3_New(0.0f, 0.0f, sign), Vec3_New(0.0f, 1.0f, 0.0f));
+    case GYROSPACE_POSTURE_FLAT:
+    default:
+        return Mat3_FromRows(Vec3_New(0.0f, sign, 0.0f), Vec3_New(1.0f, 0.0f, 0.0f), Vec3_New(0.0f, 0.0f, sign));
     }
+}
 
-    Vector3 worldRight = Vec3_Normalize(Vec3_Cross(gravity, worldFwd));
-    Vector3 worldFwdProj = Vec3_Normalize(Vec3_Cross(worldRight, gravity));
+// Per-Context State
+
+/**
+ * Per-device Gyro Space state.
+ *
+ * The global functions above share a single gravity vector; a context keeps
+ * gravity per device and caches the World Space matrix so it is only rebuilt
+ * when gravity changes, not on every sample.
+ */
+typedef struct {
+    Vector3 gravNorm;   // Normalized gravity (default: (0, 1, 0))
+    Mat3 worldMatrix;   // Cached GyroSpace_BuildWorldMatrix(gravNorm)
+
+    // Dynamic Orientation
+    bool dynamicOrientation;     // Detect posture on every gravity update
+    float postureHysteresis;     // See GYROSPACE_POSTURE_HYSTERESIS
+    GyroSpacePosture posture;
+    float postureSign;           // Sign of gravity along the posture axis
+    uint32_t postureChanges;     // Number of posture transitions so far
+    Mat3 axisMatrix;             // Sensor (x, y, z) -> (yaw, pitch, roll) for the current posture
 
-    // Calculate world axes rotations
-    float worldYaw   = Vec3_Dot(gyro, gravity);
-    float worldPitch = Vec3_Dot(gyro, worldRight);
-    float worldRoll  = Vec3_Dot(gyro, worldFwdProj);
+    // Gravity Source
+    GyroSpaceGravityPolicy gravityPolicy;   // Ignored when GYROSPACE_GRAVITY_POLICY is defined
 
-    // Output as (pitch, yaw, roll) for typical FPS/game engines
-    return Vec3_New(worldPitch, worldYaw, worldRoll);
+    // Shake Rejection
+    bool shakeRejection;         // Gate gravity updates on |accel| staying near 1 g
+    float gravityBandMin2;       // Accepted squared accel magnitude range
+    float gravityBandMax2;
+    uint32_t shakeRejections;    // Accel samples rejected so far
+
+    // Angle Accumulation (double running sums; per-sample math stays float)
+    double angleX, angleY, angleZ;
+} GyroSpaceContext;
+
+/** Initializes a context to Y-up gravity, flat posture and dynamic orientation disabled. */
+static inline void GyroSpace_InitContext(GyroSpaceContext* ctx) {
+    ctx->gravNorm = Vec3_New(0.0f, 1.0f, 0.0f);
+    ctx->worldMatrix = GyroSpace_BuildWorldMatrix(ctx->gravNorm);
+
+    ctx->dynamicOrientation = false;
+    ctx->postureHysteresis = GYROSPACE_POSTURE_HYSTERESIS;
+    ctx->posture = GYROSPACE_POSTURE_FLAT;
+    ctx->postureSign = 1.0f;
+    ctx->postureChanges = 0;
+    ctx->axisMatrix = GyroSpace_BuildAxisMatrix(ctx->posture, ctx->postureSign);
+
+    ctx->gravityPolicy = GYROSPACE_GRAVITY_RAW;
+
+    ctx->shakeRejection = false;
+    ctx->gravityBandMin2 = 0.0f;
+    ctx->gravityBandMax2 = INFINITY;
+    ctx->shakeRejections = 0;
+
+    ctx->angleX = ctx->angleY = ctx->angleZ = 0.0;
 }
- 
+
+/**
+ * Enables or disables dynamic orientation. hysteresis is the margin a new
+ * axis must beat the current one by (pass GYROSPACE_POSTURE_HYSTERESIS for
+ * the default); larger values hold a posture longer near 45 degrees.
+ */
+static inline void GyroSpace_SetDynamicOrientation(GyroSpaceContext* ctx, bool enabled, float hysteresis) {
+    ctx->dynamicOrientation = enabled;
+    ctx->postureHysteresis = fmaxf(hysteresis, 0.0f);
+}
+
+/**
+ * Re-classifies the posture from the context gravity vector.
+ * Holding a posture costs a few compares; the axis matrix is only rebuilt
+ * on a transition. Returns true if the posture changed.
+ */
+static inline bool GyroSpace_UpdatePosture(GyroSpaceContext* ctx) {
+    const float g[3] = { ctx->gravNorm.x, ctx->gravNorm.y, ctx->gravNorm.z };
+    static const int postureAxis[3] = { 1, 2, 0 }; // FLAT -> Y, LANDSCAPE -> Z, PORTRAIT -> X
+
+    // Keep the current posture while its axis is still within the hysteresis band
+    float current = g[postureAxis[ctx->posture]] * ctx->postureSign;
+    float ax = fabsf(g[0]), ay = fabsf(g[1]), az = fabsf(g[2]);
+    float threshold = current + ctx->postureHysteresis;
+    if (current > 0.0f && ax <= threshold && ay <= threshold && az <= threshold)
+        return false;
+
+    GyroSpacePosture posture = (ay >= ax && ay >= az) ? GYROSPACE_POSTURE_FLAT
+                             : (az >= ax)             ? GYROSPACE_POSTURE_LANDSCAPE
+                                                      : GYROSPACE_POSTURE_PORTRAIT;
+    float sign = (g[postureAxis[posture]] >= 0.0f) ? 1.0f : -1.0f;
+    if (posture == ctx->posture && sign == ctx->postureSign)
+        return false;
+
+    ctx->posture = posture;
+    ctx->postureSign = sign;
+    ctx->postureChanges++;
+    ctx->axisMatrix = GyroSpace_BuildAxisMatrix(posture, sign);
+    return true;
+}
+
+/** Rebuilds the state derived from the context gravity vector. */
+static inline void GyroSpace_GravityChanged(GyroSpaceContext* ctx) {
+    ctx->worldMatrix = GyroSpace_BuildWorldMatrix(ctx->gravNorm);
+    if (ctx->dynamicOrientation)
+        GyroSpace_UpdatePosture(ctx);
+}
+
+/**
+ * Enables or disables shake rejection. Accel samples whose magnitude is
+ * outside oneG * (1 +- tolerance) are treated as linear acceleration from
+ * fast aiming and do not update gravity (oneG is 1.0 for accel in g, 9.81
+ * for m/s^2; tolerance 0.1-0.2 is typical). Rejected samples also skip the
+ * World Space rebuild.
+ */
+static inline void GyroSpace_SetShakeRejection(GyroSpaceContext* ctx, bool enabled, float oneG, float tolerance) {
+    float low = fmaxf(oneG * (1.0f - tolerance), 0.0f);
+    float high = oneG * (1.0f + tolerance);
+    ctx->shakeRejection = enabled;
+    ctx->gravityBandMin2 = low * low;
+    ctx->gravityBandMax2 = high * high;
+}
+
+/** Returns true if shake rejection lets the accel sample through, counting it otherwise. */
+static inline bool GyroSpace_AcceptGravitySample(GyroSpaceContext* ctx, Vector3 accel) {
+    if (!ctx->shakeRejection || GyroSpace_AccelInGravityBand(accel, ctx->gravityBandMin2, ctx->gravityBandMax2))
+        return true;
+    ctx->shakeRejections++;
+    return false;
+}
+
+/** Returns the number of accel samples rejected by shake rejection. */
+static inline uint32_t GyroSpace_GetShakeRejections(const GyroSpaceContext* ctx) {
+    return ctx->shakeRejections;
+}
+
+/** Sets the context gravity vector (raw accel data) and rebuilds the World Space matrix. */
+static inline void GyroSpace_SetGravityVector(GyroSpaceContext* ctx, float x, float y, float z) {
+    if (!GyroSpace_AcceptGravitySample(ctx, Vec3_New(x, y, z)))
+        return;
+    if (GyroSpace_ResolveGravity(x, y, z, &ctx->gravNorm))
+        GyroSpace_GravityChanged(ctx);
+}
+
+/** Selects how GyroSpace_UpdateGravity estimates gravity for the context. */
+static inline void GyroSpace_SetGravityPolicy(GyroSpaceContext* ctx, GyroSpaceGravityPolicy policy) {
+    ctx->gravityPolicy = policy;
+}
+
+/**
+ * Updates the context gravity vector from an accel sample and the gyro
+ * rotation (degrees per second, sensor axes) under the context's gravity
+ * policy. fusionFactor is the per-sample weight of the accel sample for
+ * the LOWPASS and FUSED policies. When shake rejection drops a sample, the
+ * FUSED policy keeps following the gyro with the accel weight at zero.
+ */
+static inline void GyroSpace_UpdateGravity(GyroSpaceContext* ctx, Vector3 accel, Vector3 gyroRotation,
+                                           float fusionFactor, float deltaTime) {
+#ifdef GYROSPACE_GRAVITY_POLICY
+    const GyroSpaceGravityPolicy policy = GYROSPACE_GRAVITY_POLICY;
+#else
+    const GyroSpaceGravityPolicy policy = ctx->gravityPolicy;
+#endif
+    if (!GyroSpace_AcceptGravitySample(ctx, accel)) {
+        if (policy != GYROSPACE_GRAVITY_FUSED)
+            return;
+        Vector3 rotated = GyroSpace_RotateGravity(ctx->gravNorm, gyroRotation, deltaTime);
+        if (GyroSpace_ResolveGravity(rotated.x, rotated.y, rotated.z, &ctx->gravNorm))
+            GyroSpace_GravityChanged(ctx);
+        return;
+    }
+    if (GyroSpace_ApplyGravityPolicy(policy, &ctx->gravNorm, accel, gyroRotation, fusionFactor, deltaTime))
+        GyroSpace_GravityChanged(ctx);
+}
+
+/** Returns the posture detected for the context. */
+static inline GyroSpacePosture GyroSpace_GetPosture(const GyroSpaceContext* ctx) {
+    return ctx->posture;
+}
+
+/**
+ * Maps raw sensor gyro (x, y, z) to (yaw, pitch, roll) for the current
+ * posture, ready to pass to the TransformTo*Space functions.
+ */
+static inline Vector3 GyroSpace_MapSensorAxes(const GyroSpaceContext* ctx, Vector3 sensorGyro) {
+    return Mat3_MulVec3(&ctx->axisMatrix, sensorGyro);
+}
+
+/** Returns the context gravity vector. */
+static inline Vector3 GyroSpace_GetGravityVector(const GyroSpaceContext* ctx) {
+    return ctx->gravNorm;
+}
+
+/**
+ * Returns the World Space matrix for the context's current gravity.
+ * Engines can fold this into their own camera matrices instead of calling
+ * TransformToWorldSpace per sample.
+ */
+static inline Mat3 GyroSpace_GetWorldMatrix(const GyroSpaceContext* ctx) {
+    return ctx->worldMatrix;
+}
+
+/** Transforms gyro inputs to World Space using the context's cached matrix. */
+static inline Vector3 GyroSpace_TransformToWorldSpace(const GyroSpaceContext* ctx, float yaw, float pitch, float roll) {
+    return Mat3_MulVec3(&ctx->worldMatrix, Vec3_New(yaw, pitch, roll));
+}
+
+/** Transforms an aligned (yaw, pitch, roll) gyro vector to World Space. */
+static inline Vector3A GyroSpace_TransformToWorldSpaceA(const GyroSpaceContext* ctx, Vector3A gyro) {
+    return Mat3_MulVec3A(&ctx->worldMatrix, gyro);
+}
+
+/** Transforms gyro inputs to Player Space using the context's gravity vector. */
+static inline Vector3 GyroSpace_TransformToPlayerSpace(const GyroSpaceContext* ctx, float yaw, float pitch, float roll) {
+    return GyroSpace_PlayerSpaceForGravity(ctx->gravNorm, yaw, pitch, roll);
+}
+
+/**
+ * Batch World Space transform over SoA arrays.
+ * Writes (pitch, yaw, roll) to outPitch/outYaw/outRoll for each input sample.
+ * Output arrays must not alias the inputs (the kernel is restrict-qualified);
+ * transform in place with GyroSpace_TransformToWorldSpace per sample instead.
+ */
+static inline void GyroSpace_TransformToWorldSpaceBatch(const GyroSpaceContext* ctx,
+                                                        const float* yaw, const float* pitch, const float* roll,
+                                                        float* outPitch, float* outYaw, float* outRoll,
+                                                        size_t count) {
+    Mat3_MulVec3Batch(&ctx->worldMatrix, yaw, pitch, roll, outPitch, outYaw, outRoll, count);
+}
+
+/**
+ * Batch World Space transform over packed (yaw, pitch, roll) triplets
+ * (float[count][3] or a Vector3 array via &v[0].x), writing SoA output.
+ * Output arrays must not overlap the input.
+ */
+static inline void GyroSpace_TransformToWorldSpaceArrayBatch(const GyroSpaceContext* ctx, const float* yawPitchRoll,
+                                                             float* outPitch, float* outYaw, float* outRoll,
+                                                             size_t count) {
+    Mat3_MulVec3InterleavedBatch(&ctx->worldMatrix, yawPitchRoll, outPitch, outYaw, outRoll, count);
+}
+
+/**
+ * Batch World Space transform straight from raw sensor reports, e.g. the
+ * float data[3] of SDL gyro events stored back to back. The posture's axis
+ * mapping and the World Space matrix are folded into one matrix, so each
+ * sample is transposed and transformed in a single pass. Output arrays must
+ * not overlap the input.
+ */
+static inline void GyroSpace_TransformSensorToWorldSpaceBatch(const GyroSpaceContext* ctx, const float* sensorXYZ,
+                                                              float* outPitch, float* outYaw, float* outRoll,
+                                                              size_t count) {
+    const Mat3 combined = Mat3_Multiply(ctx->worldMatrix, ctx->axisMatrix);
+    Mat3_MulVec3InterleavedBatch(&combined, sensorXYZ, outPitch, outYaw, outRoll, count);
+}
+
+// Angle Accumulation
+
+/**
+ * Integrates a transformed angular rate over dt seconds into the context's
+ * absolute angle, e.g. a heading built from TransformTo*Space output.
+ * Summing in float drifts once the total dwarfs each step (after an hour at
+ * 1000 Hz a float sum has lost most of a 0.001-degree step); the double sum
+ * keeps the error per step near 1e-16 of the total.
+ */
+static inline void GyroSpace_AccumulateAngle(GyroSpaceContext* ctx, Vector3 rate, float dt) {
+    ctx->angleX += (double)(rate.x * dt);
+    ctx->angleY += (double)(rate.y * dt);
+    ctx->angleZ += (double)(rate.z * dt);
+}
+
+/** Accumulates SoA rates sampled at a fixed dt. */
+static inline void GyroSpace_AccumulateAngleBatch(GyroSpaceContext* ctx,
+                                                  const float* x, const float* y, const float* z,
+                                                  float dt, size_t count) {
+    double sumX = ctx->angleX, sumY = ctx->angleY, sumZ = ctx->angleZ;
+    for (size_t i = 0; i < count; ++i) {
+        sumX += (double)(x[i] * dt);
+        sumY += (double)(y[i] * dt);
+        sumZ += (double)(z[i] * dt);
+    }
+    ctx->angleX = sumX;
+    ctx->angleY = sumY;
+    ctx->angleZ = sumZ;
+}
+
+/** Returns the accumulated angle. Large totals lose precision in the float result; see GyroSpace_GetAccumulatedHeading. */
+static inline Vector3 GyroSpace_GetAccumulatedAngle(const GyroSpaceContext* ctx) {
+    return Vec3_New((float)ctx->angleX, (float)ctx->angleY, (float)ctx->angleZ);
+}
+
+/** Returns the accumulated angle in degrees, wrapped to [-180, 180) in double before narrowing. */
+static inline Vector3 GyroSpace_GetAccumulatedHeading(const GyroSpaceContext* ctx) {
+    const double a[3] = { ctx->angleX, ctx->angleY, ctx->angleZ };
+    float out[3];
+    for (int i = 0; i < 3; ++i)
+        out[i] = (float)(a[i] - 360.0 * floor((a[i] + 180.0) / 360.0));
+    return Vec3_New(out[0], out[1], out[2]);
+}
+
+/** Resets the accumulated angle to zero. */
+static inline void GyroSpace_ResetAccumulatedAngle(GyroSpaceContext* ctx) {
+    ctx->angleX = ctx->angleY = ctx->angleZ = 0.0;
+}
+
+// Context Pool
+
+/** Alignment of pooled contexts and their bookkeeping arrays. */
+#ifndef GYROSPACE_CACHE_LINE
+    #define GYROSPACE_CACHE_LINE 64
+#endif
+
+#define GYROSPACE_INVALID_HANDLE UINT32_MAX
+
+typedef uint32_t GyroSpaceContextHandle;
+
+/**
+ * Fixed-capacity pool of device contexts in one contiguous, cache-line
+ * aligned block. Handles are indices, so a context never moves while it is
+ * held, and acquiring from a fresh pool hands out 0, 1, 2, ... so per-device
+ * loops walk memory linearly. No allocation happens after creation.
+ */
+typedef struct {
+    GyroSpaceContext* contexts;   // capacity entries
+    uint32_t* nextFree;           // Free-list links, parallel to contexts
+    uint8_t* live;                // 1 while a context is acquired
+    uint32_t capacity;
+    uint32_t count;               // Contexts currently acquired
+    uint32_t freeHead;            // First free index, or GYROSPACE_INVALID_HANDLE
+
+    void* allocation;             // Block to pass to release (NULL for caller-owned memory)
+    size_t allocationSize;
+    void (*release)(void* allocation, size_t size);
+} GyroSpaceContextPool;
+
+/** Rounds size up to a multiple of GYROSPACE_CACHE_LINE. */
+static inline size_t GyroSpace_CacheLineRound(size_t size) {
+    return (size + GYROSPACE_CACHE_LINE - 1) & ~(size_t)(GYROSPACE_CACHE_LINE - 1);
+}
+
+/** Bytes of memory a pool of the given capacity needs. */
+static inline size_t GyroSpace_ContextPoolBytes(uint32_t capacity) {
+    return GyroSpace_CacheLineRound(sizeof(GyroSpaceContext) * capacity)
+         + GyroSpace_CacheLineRound(sizeof(uint32_t) * capacity)
+         + GyroSpace_CacheLineRound(capacity);
+}
+
+/**
+ * Initializes a pool over caller-provided memory of at least
+ * GyroSpace_ContextPoolBytes(capacity) bytes, aligned to GYROSPACE_CACHE_LINE.
+ * Returns false if the memory is too small or misaligned.
+ */
+static inline bool GyroSpace_InitContextPool(GyroSpaceContextPool* pool, void* memory, size_t size, uint32_t capacity) {
+    // A pool that fails to initialize is left empty, so acquire and destroy stay safe
+    pool->contexts = NULL;
+    pool->nextFree = NULL;
+    pool->live = NULL;
+    pool->capacity = pool->count = 0;
+    pool->freeHead = GYROSPACE_INVALID_HANDLE;
+    pool->allocation = NULL;
+    pool->allocationSize = 0;
+    pool->release = NULL;
+
+    if (memory == NULL || capacity == 0 || capacity == GYROSPACE_INVALID_HANDLE ||
+        size < GyroSpace_ContextPoolBytes(capacity) || ((uintptr_t)memory & (GYROSPACE_CACHE_LINE - 1)) != 0)
+        return false;
+
+    uint8_t* base = (uint8_t*)memory;
+    pool->contexts = (GyroSpaceContext*)base;
+    base += GyroSpace_CacheLineRound(sizeof(GyroSpaceContext) * capacity);
+    pool->nextFree = (uint32_t*)base;
+    base += GyroSpace_CacheLineRound(sizeof(uint32_t) * capacity);
+    pool->live = base;
+
+    pool->capacity = capacity;
+    pool->freeHead = 0;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        pool->nextFree[i] = (i + 1 < capacity) ? i + 1 : GYROSPACE_INVALID_HANDLE;
+        pool->live[i] = 0;
+    }
+    return true;
+}
+
+/** Release callback for GyroSpace_CreateContextPool; the aligned block's malloc pointer sits just before it. */
+static inline void GyroSpace_ReleaseContextPoolHeap(void* allocation, size_t size) {
+    (void)size;
+    free(((void**)allocation)[-1]);
+}
+
+/** Creates a pool on the heap with a single allocation. Returns false if allocation fails. */
+static inline bool GyroSpace_CreateContextPool(GyroSpaceContextPool* pool, uint32_t capacity) {
+    size_t size = GyroSpace_ContextPoolBytes(capacity);
+    void* raw = malloc(size + GYROSPACE_CACHE_LINE + sizeof(void*));
+    if (raw == NULL)
+        return GyroSpace_InitContextPool(pool, NULL, 0, 0);
+
+    uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + GYROSPACE_CACHE_LINE - 1) & ~(uintptr_t)(GYROSPACE_CACHE_LINE - 1);
+    ((void**)aligned)[-1] = raw;
+    if (!GyroSpace_InitContextPool(pool, (void*)aligned, size, capacity)) {
+        free(raw);
+        return false;
+    }
+
+    pool->allocation = (void*)aligned;
+    pool->allocationSize = size;
+    pool->release = GyroSpace_ReleaseContextPoolHeap;
+    return true;
+}
+
+/** Frees the pool's memory if the pool allocated it. All handles become invalid. */
+static inline void GyroSpace_DestroyContextPool(GyroSpaceContextPool* pool) {
+    if (pool->release != NULL && pool->allocation != NULL)
+        pool->release(pool->allocation, pool->allocationSize);
+    pool->contexts = NULL;
+    pool->nextFree = NULL;
+    pool->live = NULL;
+    pool->capacity = pool->count = 0;
+    pool->freeHead = GYROSPACE_INVALID_HANDLE;
+    pool->allocation = NULL;
+    pool->release = NULL;
+}
+
+/** Takes a context from the pool and initializes it. Returns GYROSPACE_INVALID_HANDLE when the pool is full. */
+static inline GyroSpaceContextHandle GyroSpace_AcquireContext(GyroSpaceContextPool* pool) {
+    uint32_t index = pool->freeHead;
+    if (index == GYROSPACE_INVALID_HANDLE)
+        return GYROSPACE_INVALID_HANDLE;
+
+    pool->freeHead = pool->nextFree[index];
+    pool->live[index] = 1;
+    pool->count++;
+    GyroSpace_InitContext(&pool->contexts[index]);
+    return index;
+}
+
+/** Returns a context to the pool. Releasing a free or out-of-range handle does nothing. */
+static inline void GyroSpace_ReleaseContext(GyroSpaceContextPool* pool, GyroSpaceContextHandle handle) {
+    if (handle >= pool->capacity || !pool->live[handle])
+        return;
+
+    pool->live[handle] = 0;
+    pool->nextFree[handle] = pool->freeHead;
+    pool->freeHead = handle;
+    pool->count--;
+}
+
+/** Returns true if the handle refers to an acquired context. */
+static inline bool GyroSpace_ContextPoolIsLive(const GyroSpaceContextPool* pool, GyroSpaceContextHandle handle) {
+    return handle < pool->capacity && pool->live[handle];
+}
+
+/** Returns the context for a handle, or NULL if it is not acquired. */
+static inline GyroSpaceContext* GyroSpace_PoolContext(GyroSpaceContextPool* pool, GyroSpaceContextHandle handle) {
+    return GyroSpace_ContextPoolIsLive(pool, handle) ? &pool->contexts[handle] : NULL;
+}
+
+// Device Slot Map
+
+/** Maximum devices a slot map tracks (at most 65535). */
+#ifndef GYROSPACE_SLOTMAP_CAPACITY
+    #define GYROSPACE_SLOTMAP_CAPACITY 64
+#endif
+
+#define GYROSPACE_SLOTMAP_HASH_SIZE (2 * GYROSPACE_SLOTMAP_CAPACITY)
+#define GYROSPACE_SLOTMAP_EMPTY 0xFFFFu
+
+/** Slot index in the low 16 bits, generation in the high 16 bits. */
+typedef uint32_t GyroSpaceDeviceHandle;
+
+/**
+ * Registry mapping device IDs (SDL instance IDs, evdev paths hashed by the
+ * caller, ...) to contexts for controller hotplug. Insert, find and remove
+ * are O(1) and never allocate. Live contexts are packed at the front of
+ * contexts[] for dense iteration; removal moves the last one into the hole,
+ * so handles stay valid but context pointers only last until the next
+ * remove. Each slot's generation advances on removal, so a handle kept past
+ * a disconnect is rejected instead of aliasing the next device.
+ */
+typedef struct {
+    GyroSpaceContext contexts[GYROSPACE_SLOTMAP_CAPACITY];   // Dense; first count are live
+    uint64_t deviceIds[GYROSPACE_SLOTMAP_CAPACITY];          // Dense, parallel to contexts
+    uint16_t denseToSlot[GYROSPACE_SLOTMAP_CAPACITY];
+
+    uint16_t slotDense[GYROSPACE_SLOTMAP_CAPACITY];          // Dense index when live, next free slot when free
+    uint16_t slotGeneration[GYROSPACE_SLOTMAP_CAPACITY];
+    uint16_t freeHead;
+    uint32_t count;
+
+    // Device ID -> slot, open addressing with linear probing
+    uint64_t hashIds[GYROSPACE_SLOTMAP_HASH_SIZE];
+    uint16_t hashSlots[GYROSPACE_SLOTMAP_HASH_SIZE];
+} GyroSpaceSlotMap;
+
+/** Initializes an empty slot map. */
+static inline void GyroSpace_InitSlotMap(GyroSpaceSlotMap* map) {
+    for (uint32_t i = 0; i < GYROSPACE_SLOTMAP_CAPACITY; ++i) {
+        map->slotDense[i] = (uint16_t)((i + 1 < GYROSPACE_SLOTMAP_CAPACITY) ? i + 1 : GYROSPACE_SLOTMAP_EMPTY);
+        map->slotGeneration[i] = 0;
+    }
+    for (uint32_t i = 0; i < GYROSPACE_SLOTMAP_HASH_SIZE; ++i)
+        map->hashSlots[i] = GYROSPACE_SLOTMAP_EMPTY;
+    map->freeHead = 0;
+    map->count = 0;
+}
+
+/** Home bucket for a device ID. */
+static inline uint32_t GyroSpace_SlotMapBucket(uint64_t deviceId) {
+    return (uint32_t)((deviceId * 0x9E3779B97F4A7C15ull) >> 32) % GYROSPACE_SLOTMAP_HASH_SIZE;
+}
+
+/** Returns the hash bucket holding deviceId, or GYROSPACE_SLOTMAP_HASH_SIZE if absent. */
+static inline uint32_t GyroSpace_SlotMapFindBucket(const GyroSpaceSlotMap* map, uint64_t deviceId) {
+    uint32_t b = GyroSpace_SlotMapBucket(deviceId);
+    while (map->hashSlots[b] != GYROSPACE_SLOTMAP_EMPTY) {
+        if (map->hashIds[b] == deviceId)
+            return b;
+        b = (b + 1) % GYROSPACE_SLOTMAP_HASH_SIZE;
+    }
+    return GYROSPACE_SLOTMAP_HASH_SIZE;
+}
+
+/** Builds the current handle for a slot. */
+static inline GyroSpaceDeviceHandle GyroSpace_SlotMapHandle(const GyroSpaceSlotMap* map, uint32_t slot) {
+    return ((GyroSpaceDeviceHandle)map->slotGeneration[slot] << 16) | slot;
+}
+
+/** Returns the handle for deviceId, or GYROSPACE_INVALID_HANDLE if it is not registered. */
+static inline GyroSpaceDeviceHandle GyroSpace_SlotMapFind(const GyroSpaceSlotMap* map, uint64_t deviceId) {
+    uint32_t b = GyroSpace_SlotMapFindBucket(map, deviceId);
+    return (b < GYROSPACE_SLOTMAP_HASH_SIZE) ? GyroSpace_SlotMapHandle(map, map->hashSlots[b]) : GYROSPACE_INVALID_HANDLE;
+}
+
+/**
+ * Registers a device and initializes its context. Inserting an ID that is
+ * already registered returns its existing handle. Returns
+ * GYROSPACE_INVALID_HANDLE when the map is full.
+ */
+static inline GyroSpaceDeviceHandle GyroSpace_SlotMapInsert(GyroSpaceSlotMap* map, uint64_t deviceId) {
+    GyroSpaceDeviceHandle existing = GyroSpace_SlotMapFind(map, deviceId);
+    if (existing != GYROSPACE_INVALID_HANDLE)
+        return existing;
+
+    uint32_t slot = map->freeHead;
+    if (slot == GYROSPACE_SLOTMAP_EMPTY)
+        return GYROSPACE_INVALID_HANDLE;
+    map->freeHead = map->slotDense[slot];
+
+    uint32_t dense = map->count++;
+    map->slotDense[slot] = (uint16_t)dense;
+    map->denseToSlot[dense] = (uint16_t)slot;
+    map->deviceIds[dense] = deviceId;
+    GyroSpace_InitContext(&map->contexts[dense]);
+
+    uint32_t b = GyroSpace_SlotMapBucket(deviceId);
+    while (map->hashSlots[b] != GYROSPACE_SLOTMAP_EMPTY)
+        b = (b + 1) % GYROSPACE_SLOTMAP_HASH_SIZE;
+    map->hashIds[b] = deviceId;
+    map->hashSlots[b] = (uint16_t)slot;
+
+    return GyroSpace_SlotMapHandle(map, slot);
+}
+
+/** Returns true if the handle refers to a registered device (not a stale one). */
+static inline bool GyroSpace_SlotMapIsValid(const GyroSpaceSlotMap* map, GyroSpaceDeviceHandle handle) {
+    uint32_t slot = handle & 0xFFFFu;
+    return slot < GYROSPACE_SLOTMAP_CAPACITY && map->slotGeneration[slot] == (handle >> 16) &&
+           map->slotDense[slot] < map->count && map->denseToSlot[map->slotDense[slot]] == slot;
+}
+
+/** Returns the context for a handle, or NULL if the handle is stale. Valid until the next remove. */
+static inline GyroSpaceContext* GyroSpace_SlotMapGet(GyroSpaceSlotMap* map, GyroSpaceDeviceHandle handle) {
+    return GyroSpace_SlotMapIsValid(map, handle) ? &map->contexts[map->slotDense[handle & 0xFFFFu]] : NULL;
+}
+
+/** Unregisters a device. Returns false if the handle is stale. */
+static inline bool GyroSpace_SlotMapRemove(GyroSpaceSlotMap* map, GyroSpaceDeviceHandle handle) {
+    if (!GyroSpace_SlotMapIsValid(map, handle))
+        return false;
+
+    uint32_t slot = handle & 0xFFFFu;
+    uint32_t dense = map->slotDense[slot];
+
+    // Remove the ID, shifting later entries of the probe run back into the gap
+    uint32_t gap = GyroSpace_SlotMapFindBucket(map, map->deviceIds[dense]);
+    uint32_t b = gap;
+    for (;;) {
+        b = (b + 1) % GYROSPACE_SLOTMAP_HASH_SIZE;
+        if (map->hashSlots[b] == GYROSPACE_SLOTMAP_EMPTY)
+            break;
+        uint32_t home = GyroSpace_SlotMapBucket(map->hashIds[b]);
+        bool movable = (gap <= b) ? (home <= gap || home > b) : (home <= gap && home > b);
+        if (movable) {
+            map->hashIds[gap] = map->hashIds[b];
+            map->hashSlots[gap] = map->hashSlots[b];
+            gap = b;
+        }
+    }
+    map->hashSlots[gap] = GYROSPACE_SLOTMAP_EMPTY;
+
+    // Keep live contexts packed by moving the last one into the hole
+    uint32_t last = --map->count;
+    if (dense != last) {
+        map->contexts[dense] = map->contexts[last];
+        map->deviceIds[dense] = map->deviceIds[last];
+        map->denseToSlot[dense] = map->denseToSlot[last];
+        map->slotDense[map->denseToSlot[dense]] = (uint16_t)dense;
+    }
+
+    map->slotGeneration[slot]++;
+    map->slotDense[slot] = map->freeHead;
+    map->freeHead = (uint16_t)slot;
+    return true;
+}
+
+/** Unregisters a device by ID. Returns false if it was not registered. */
+static inline bool GyroSpace_SlotMapRemoveDevice(GyroSpaceSlotMap* map, uint64_t deviceId) {
+    return GyroSpace_SlotMapRemove(map, GyroSpace_SlotMapFind(map, deviceId));
+}
+
+/** Returns the handle of the live device at dense index i (0 <= i < map->count). */
+static inline GyroSpaceDeviceHandle GyroSpace_SlotMapHandleAt(const GyroSpaceSlotMap* map, uint32_t i) {
+    return GyroSpace_SlotMapHandle(map, map->denseToSlot[i]);
+}
+
+// One Euro Filter
+
+/**
+ * One Euro filter over the three output axes (Casiez et al.): a low-pass
+ * whose cutoff rises with speed, so slow aiming is smoothed while fast turns
+ * keep their latency low. Plugs in after any TransformTo*Space call.
+ *
+ * State is O(1) per axis and the three axes run in SIMD lanes. The sample
+ * period is fixed per filter, so the derivative smoothing factor is cached
+ * and each sample costs one division instead of expf calls.
+ */
+typedef struct {
+    Vector3A value;           // Filtered output of the previous sample
+    Vector3A derivative;      // Filtered speed of the previous sample
+    float minCutoff;          // Hz; cutoff at rest
+    float beta;               // Cutoff increase per unit of speed
+    float sampleRate;         // Hz
+    float twoPiPeriod;        // 2*pi / sampleRate, cached
+    float derivativeAlpha;    // Smoothing factor for the derivative cutoff, cached
+    bool initialized;
+} GyroSpaceOneEuroFilter;
+
+/** Smoothing factor of a first-order low-pass for cutoff (Hz), given 2*pi*period. */
+static inline float GyroSpace_LowPassAlpha(float cutoff, float twoPiPeriod) {
+    float a = twoPiPeriod * cutoff;
+    return a / (a + 1.0f);
+}
+
+/** Changes the sample rate, recomputing cached factors. Keeps the filter state. */
+static inline void GyroSpace_SetOneEuroSampleRate(GyroSpaceOneEuroFilter* f, float sampleRate, float derivativeCutoff) {
+    f->sampleRate = sampleRate;
+    f->twoPiPeriod = 6.28318530718f / sampleRate;
+    f->derivativeAlpha = GyroSpace_LowPassAlpha(derivativeCutoff, f->twoPiPeriod);
+}
+
+/**
+ * Initializes a One Euro filter.
+ * minCutoff and derivativeCutoff are in Hz (1.0 is a typical start for both),
+ * beta scales how quickly the cutoff opens up with angular speed.
+ */
+static inline void GyroSpace_InitOneEuroFilter(GyroSpaceOneEuroFilter* f, float minCutoff, float beta,
+                                               float derivativeCutoff, float sampleRate) {
+    f->value = Vec3A_New(0.0f, 0.0f, 0.0f);
+    f->derivative = Vec3A_New(0.0f, 0.0f, 0.0f);
+    f->minCutoff = minCutoff;
+    f->beta = beta;
+    f->initialized = false;
+    GyroSpace_SetOneEuroSampleRate(f, sampleRate, derivativeCutoff);
+}
+
+/** Clears the filter history; the next sample passes through unchanged. */
+static inline void GyroSpace_ResetOneEuroFilter(GyroSpaceOneEuroFilter* f) {
+    f->initialized = false;
+}
+
+/** Filters one aligned sample. */
+static inline Vector3A GyroSpace_OneEuroFilterA(GyroSpaceOneEuroFilter* f, Vector3A input) {
+    if (!f->initialized) {
+        f->value = input;
+        f->derivative = Vec3A_New(0.0f, 0.0f, 0.0f);
+        f->initialized = true;
+        return input;
+    }
+
+#if GYROSPACE_SSE
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 x = Vec3A_Load(&input);
+    __m128 prev = Vec3A_Load(&f->value);
+    __m128 dPrev = Vec3A_Load(&f->derivative);
+
+    __m128 dx = _mm_mul_ps(_mm_sub_ps(x, prev), _mm_set1_ps(f->sampleRate));
+    __m128 d = _mm_add_ps(dPrev, _mm_mul_ps(_mm_set1_ps(f->derivativeAlpha), _mm_sub_ps(dx, dPrev)));
+    __m128 cutoff = _mm_add_ps(_mm_set1_ps(f->minCutoff), _mm_mul_ps(_mm_set1_ps(f->beta), _mm_max_ps(d, _mm_sub_ps(_mm_setzero_ps(), d))));
+    __m128 a = _mm_mul_ps(_mm_set1_ps(f->twoPiPeriod), cutoff);
+    __m128 alpha = _mm_div_ps(a, _mm_add_ps(a, one));
+    __m128 y = _mm_add_ps(prev, _mm_mul_ps(alpha, _mm_sub_ps(x, prev)));
+
+    f->derivative = Vec3A_FromM128(d);
+    f->value = Vec3A_FromM128(y);
+#else
+    float in[3] = { input.x, input.y, input.z };
+    float* value = &f->value.x;
+    float* derivative = &f->derivative.x;
+    for (int i = 0; i < 3; ++i) {
+        float dx = (in[i] - value[i]) * f->sampleRate;
+        derivative[i] += f->derivativeAlpha * (dx - derivative[i]);
+        float alpha = GyroSpace_LowPassAlpha(f->minCutoff + f->beta * fabsf(derivative[i]), f->twoPiPeriod);
+        value[i] += alpha * (in[i] - value[i]);
+    }
+#endif
+    return f->value;
+}
+
+/** Filters one sample (e.g. the output of a TransformTo*Space call). */
+static inline Vector3 GyroSpace_OneEuroFilter(GyroSpaceOneEuroFilter* f, Vector3 input) {
+    return Vec3A_ToVec3(GyroSpace_OneEuroFilterA(f, Vec3A_FromVec3(input)));
+}
+
+/**
+ * Filters count consecutive samples stored as SoA arrays, matching the batch
+ * transform API. Output arrays may be the same as the inputs.
+ */
+static inline void GyroSpace_OneEuroFilterBatch(GyroSpaceOneEuroFilter* f,
+                                                const float* inX, const float* inY, const float* inZ,
+                                                float* outX, float* outY, float* outZ, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Vector3A out = GyroSpace_OneEuroFilterA(f, Vec3A_New(inX[i], inY[i], inZ[i]));
+        outX[i] = out.x;
+        outY[i] = out.y;
+        outZ[i] = out.z;
+    }
+}
+
+// Biquad Filters
+
+typedef enum {
+    GYROSPACE_BIQUAD_LOWPASS = 0,
+    GYROSPACE_BIQUAD_HIGHPASS = 1,
+    GYROSPACE_BIQUAD_NOTCH = 2
+} GyroSpaceBiquadType;
+
+/** Second-order section coefficients, normalized so a0 = 1. */
+typedef struct {
+    float b0, b1, b2;
+    float a1, a2;
+} GyroSpaceBiquadCoeffs;
+
+/**
+ * Designs a biquad (RBJ audio EQ cookbook). frequency is the cutoff or notch
+ * centre in Hz. q = 0.7071 gives a Butterworth low/high-pass; for a notch,
+ * the rejected band is about frequency / q wide. Coefficients depend only on
+ * the sample rate, so compute them once per rate, not per sample.
+ */
+static inline GyroSpaceBiquadCoeffs GyroSpace_DesignBiquad(GyroSpaceBiquadType type, float frequency, float q, float sampleRate) {
+    float s, c;
+    GyroSpace_FastSinCos(2.0f * GYROSPACE_PI * frequency / sampleRate, &s, &c);
+    float alpha = s / (2.0f * q);
+    float norm = 1.0f / (1.0f + alpha);
+
+    GyroSpaceBiquadCoeffs k;
+    switch (type) {
+    case GYROSPACE_BIQUAD_HIGHPASS:
+        k.b0 = k.b2 = 0.5f * (1.0f + c) * norm;
+        k.b1 = -(1.0f + c) * norm;
+        break;
+    case GYROSPACE_BIQUAD_NOTCH:
+        k.b0 = k.b2 = norm;
+        k.b1 = -2.0f * c * norm;
+        break;
+    default:
+        k.b0 = k.b2 = 0.5f * (1.0f - c) * norm;
+        k.b1 = (1.0f - c) * norm;
+        break;
+    }
+    k.a1 = -2.0f * c * norm;
+    k.a2 = (1.0f - alpha) * norm;
+    return k;
+}
+
+/**
+ * Biquad over the three axes of a vector, e.g. raw accel before
+ * SetGravityVector to stop gravity wobbling under rumble, or gyro output.
+ * Transposed direct form II; the three axes run in SIMD lanes.
+ */
+typedef struct {
+    GyroSpaceBiquadCoeffs coeffs;
+    Vector3A z1, z2;
+} GyroSpaceBiquad;
+
+/**
+ * Clears the filter history to the steady state for a constant input, so a
+ * low-pass on accel starts at the current gravity instead of ramping from zero.
+ */
+static inline void GyroSpace_ResetBiquad(GyroSpaceBiquad* f, Vector3 value) {
+    const GyroSpaceBiquadCoeffs* k = &f->coeffs;
+    float gain = (k->b0 + k->b1 + k->b2) / (1.0f + k->a1 + k->a2);
+    Vector3A x = Vec3A_FromVec3(value);
+    Vector3A y = Vec3A_Scale(x, gain);
+    f->z1 = Vec3A_Subtract(y, Vec3A_Scale(x, k->b0));
+    f->z2 = Vec3A_Subtract(Vec3A_Scale(x, k->b2), Vec3A_Scale(y, k->a2));
+}
+
+/** Initializes a biquad with freshly designed coefficients and zeroed history. */
+static inline void GyroSpace_InitBiquad(GyroSpaceBiquad* f, GyroSpaceBiquadType type, float frequency, float q, float sampleRate) {
+    f->coeffs = GyroSpace_DesignBiquad(type, frequency, q, sampleRate);
+    GyroSpace_ResetBiquad(f, Vec3_New(0.0f, 0.0f, 0.0f));
+}
+
+/** Filters one aligned sample. */
+static inline Vector3A GyroSpace_BiquadA(GyroSpaceBiquad* f, Vector3A input) {
+    const GyroSpaceBiquadCoeffs* k = &f->coeffs;
+#if GYROSPACE_SSE
+    __m128 x = Vec3A_Load(&input);
+    __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(k->b0), x), Vec3A_Load(&f->z1));
+    __m128 z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(k->b1), x), _mm_mul_ps(_mm_set1_ps(k->a1), y)), Vec3A_Load(&f->z2));
+    __m128 z2 = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(k->b2), x), _mm_mul_ps(_mm_set1_ps(k->a2), y));
+    f->z1 = Vec3A_FromM128(z1);
+    f->z2 = Vec3A_FromM128(z2);
+    return Vec3A_FromM128(y);
+#else
+    Vector3A y = Vec3A_Add(Vec3A_Scale(input, k->b0), f->z1);
+    f->z1 = Vec3A_Add(Vec3A_Subtract(Vec3A_Scale(input, k->b1), Vec3A_Scale(y, k->a1)), f->z2);
+    f->z2 = Vec3A_Subtract(Vec3A_Scale(input, k->b2), Vec3A_Scale(y, k->a2));
+    return y;
+#endif
+}
+
+/** Filters one sample. */
+static inline Vector3 GyroSpace_Biquad(GyroSpaceBiquad* f, Vector3 input) {
+    return Vec3A_ToVec3(GyroSpace_BiquadA(f, Vec3A_FromVec3(input)));
+}
+
+/**
+ * Filters count consecutive samples stored as SoA arrays, matching the batch
+ * transform API. Output arrays may be the same as the inputs.
+ */
+static inline void GyroSpace_BiquadBatch(GyroSpaceBiquad* f,
+                                         const float* inX, const float* inY, const float* inZ,
+                                         float* outX, float* outY, float* outZ, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Vector3A out = GyroSpace_BiquadA(f, Vec3A_New(inX[i], inY[i], inZ[i]));
+        outX[i] = out.x;
+        outY[i] = out.y;
+        outZ[i] = out.z;
+    }
+}
+
+/** Channels in a biquad bank (devices x axes); rounded up to a multiple of 4. */
+#ifndef GYROSPACE_BIQUAD_BANK_MAX
+    #define GYROSPACE_BIQUAD_BANK_MAX 64
+#endif
+
+/**
+ * One biquad design applied to many independent channels, e.g. the accel
+ * axes of every connected device. State is SoA, so four channels are
+ * filtered per SIMD instruction.
+ */
+typedef struct {
+    GyroSpaceBiquadCoeffs coeffs;
+    uint32_t channels;
+    GYROSPACE_ALIGN(16) float z1[(GYROSPACE_BIQUAD_BANK_MAX + 3) & ~3];
+    GYROSPACE_ALIGN(16) float z2[(GYROSPACE_BIQUAD_BANK_MAX + 3) & ~3];
+} GyroSpaceBiquadBank;
+
+/** Initializes a bank of up to GYROSPACE_BIQUAD_BANK_MAX channels with zeroed history. */
+static inline bool GyroSpace_InitBiquadBank(GyroSpaceBiquadBank* bank, uint32_t channels, GyroSpaceBiquadType type,
+                                            float frequency, float q, float sampleRate) {
+    if (channels > GYROSPACE_BIQUAD_BANK_MAX)
+        return false;
+    bank->coeffs = GyroSpace_DesignBiquad(type, frequency, q, sampleRate);
+    bank->channels = channels;
+    for (uint32_t i = 0; i < (uint32_t)((GYROSPACE_BIQUAD_BANK_MAX + 3) & ~3); ++i)
+        bank->z1[i] = bank->z2[i] = 0.0f;
+    return true;
+}
+
+/** Filters one sample on every channel: out[c] = filter_c(in[c]). out may equal in. */
+static inline void GyroSpace_BiquadBankProcess(GyroSpaceBiquadBank* bank, const float* in, float* out) {
+    const GyroSpaceBiquadCoeffs k = bank->coeffs;
+    uint32_t c = 0;
+#if GYROSPACE_SSE
+    const __m128 b0 = _mm_set1_ps(k.b0), b1 = _mm_set1_ps(k.b1), b2 = _mm_set1_ps(k.b2);
+    const __m128 a1 = _mm_set1_ps(k.a1), a2 = _mm_set1_ps(k.a2);
+    for (; c + 4 <= bank->channels; c += 4) {
+        __m128 x = _mm_loadu_ps(in + c);
+        __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), _mm_load_ps(bank->z1 + c));
+        __m128 z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), _mm_load_ps(bank->z2 + c));
+        _mm_store_ps(bank->z2 + c, _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y)));
+        _mm_store_ps(bank->z1 + c, z1);
+        _mm_storeu_ps(out + c, y);
+    }
+#endif
+    for (; c < bank->channels; ++c) {
+        float x = in[c];
+        float y = k.b0 * x + bank->z1[c];
+        bank->z1[c] = k.b1 * x - k.a1 * y + bank->z2[c];
+        bank->z2[c] = k.b2 * x - k.a2 * y;
+        out[c] = y;
+    }
+}
+
+/** Filters count frames of bank->channels interleaved values (frame i at in + i * channels). */
+static inline void GyroSpace_BiquadBankBatch(GyroSpaceBiquadBank* bank, const float* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        GyroSpace_BiquadBankProcess(bank, in + i * bank->channels, out + i * bank->channels);
+}
+
+// Tiered Smoothing
+
+/** Capacity of the tiered smoothing ring buffer, in samples. */
+#ifndef GYROSPACE_SMOOTHING_MAX_WINDOW
+    #define GYROSPACE_SMOOTHING_MAX_WINDOW 64
+#endif
+
+/**
+ * JoyShockMapper-style tiered soft smoothing.
+ *
+ * Inputs slower than lowerThreshold are averaged over the window, inputs
+ * faster than upperThreshold pass through untouched, and speeds in between
+ * blend the two. The window average comes from a running sum over a ring
+ * buffer, so the cost per sample does not depend on the window length. The
+ * sums are kept in double so adding and removing samples does not drift.
+ */
+typedef struct {
+    Vector3 samples[GYROSPACE_SMOOTHING_MAX_WINDOW];
+    double sumX, sumY, sumZ;
+    uint32_t window;          // Samples averaged (1..GYROSPACE_SMOOTHING_MAX_WINDOW)
+    uint32_t head;            // Next slot to overwrite
+    float invWindow;
+    float lowerThreshold;     // Speed (input units) at or below which input is fully smoothed
+    float upperThreshold;     // Speed at or above which input passes through
+    float invRange;           // 1 / (upperThreshold - lowerThreshold)
+} GyroSpaceTieredSmoother;
+
+/** Clears the smoothing history. */
+static inline void GyroSpace_ResetTieredSmoother(GyroSpaceTieredSmoother* s) {
+    for (uint32_t i = 0; i < GYROSPACE_SMOOTHING_MAX_WINDOW; ++i)
+        s->samples[i] = Vec3_New(0.0f, 0.0f, 0.0f);
+    s->sumX = s->sumY = s->sumZ = 0.0;
+    s->head = 0;
+}
+
+/**
+ * Initializes a tiered smoother. window is clamped to
+ * [1, GYROSPACE_SMOOTHING_MAX_WINDOW]; thresholds are angular speeds in the
+ * units of the transformed gyro output.
+ */
+static inline void GyroSpace_InitTieredSmoother(GyroSpaceTieredSmoother* s, uint32_t window,
+                                                float lowerThreshold, float upperThreshold) {
+    if (window < 1) window = 1;
+    if (window > GYROSPACE_SMOOTHING_MAX_WINDOW) window = GYROSPACE_SMOOTHING_MAX_WINDOW;
+
+    s->window = window;
+    s->invWindow = 1.0f / (float)window;
+    s->lowerThreshold = lowerThreshold;
+    s->upperThreshold = fmaxf(upperThreshold, lowerThreshold);
+    s->invRange = (s->upperThreshold - lowerThreshold > EPSILON) ? 1.0f / (s->upperThreshold - lowerThreshold) : 0.0f;
+    GyroSpace_ResetTieredSmoother(s);
+}
+
+/** Smooths one sample (e.g. the output of a TransformTo*Space call). */
+static inline Vector3 GyroSpace_TieredSmooth(GyroSpaceTieredSmoother* s, Vector3 input) {
+    // Weight of the direct (unsmoothed) tier; a zero range is a hard switch
+    float speed = Vec3_Magnitude(input);
+    float directWeight = (s->invRange > 0.0f) ? clamp((speed - s->lowerThreshold) * s->invRange, 0.0f, 1.0f)
+                                              : (speed >= s->upperThreshold ? 1.0f : 0.0f);
+
+    Vector3 direct = Vec3_Scale(input, directWeight);
+    Vector3 smoothIn = Vec3_Subtract(input, direct);
+
+    // O(1) window update: swap the oldest sample out of the running sum
+    Vector3 oldest = s->samples[s->head];
+    s->sumX += (double)smoothIn.x - (double)oldest.x;
+    s->sumY += (double)smoothIn.y - (double)oldest.y;
+    s->sumZ += (double)smoothIn.z - (double)oldest.z;
+    s->samples[s->head] = smoothIn;
+    s->head = (s->head + 1 == s->window) ? 0 : s->head + 1;
+
+    Vector3 smoothed = Vec3_Scale(Vec3_New((float)s->sumX, (float)s->sumY, (float)s->sumZ), s->invWindow);
+    return Vec3_Add(direct, smoothed);
+}
+
+/**
+ * Smooths count consecutive samples stored as SoA arrays, matching the batch
+ * transform API. Output arrays may be the same as the inputs.
+ */
+static inline void GyroSpace_TieredSmoothBatch(GyroSpaceTieredSmoother* s,
+                                               const float* inX, const float* inY, const float* inZ,
+                                               float* outX, float* outY, float* outZ, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 out = GyroSpace_TieredSmooth(s, Vec3_New(inX[i], inY[i], inZ[i]));
+        outX[i] = out.x;
+        outY[i] = out.y;
+        outZ[i] = out.z;
+    }
+}
+
+// Sensitivity Curves
+
+/** Largest number of intervals a sensitivity curve table may use. */
+#ifndef GYROSPACE_CURVE_MAX_INTERVALS
+    #define GYROSPACE_CURVE_MAX_INTERVALS 1024
+#endif
+
+/** Analytic sensitivity curve: returns the multiplier for an angular speed. */
+typedef float (*GyroSpaceCurveFunc)(float speed, void* userData);
+
+/**
+ * Speed-dependent sensitivity curve, precompiled into a uniformly spaced
+ * piecewise-linear table so evaluation is one multiply, one lookup and one
+ * lerp instead of powf/expf per axis.
+ */
+typedef struct {
+    float values[GYROSPACE_CURVE_MAX_INTERVALS + 1]; // Multiplier at speed i * maxSpeed / intervals
+    uint32_t intervals;
+    float maxSpeed;           // Speeds above this use the last table entry
+    float invStep;            // intervals / maxSpeed
+    float maxError;           // Largest deviation from the analytic curve measured at build time
+} GyroSpaceSensitivityCurve;
+
+/**
+ * Builds the table for func over [0, maxSpeed], doubling the table size until
+ * the error measured between table points is within epsilon. Returns false
+ * if epsilon could not be met with GYROSPACE_CURVE_MAX_INTERVALS intervals;
+ * the table is still usable and maxError reports the error reached.
+ */
+static inline bool GyroSpace_BuildSensitivityCurve(GyroSpaceSensitivityCurve* curve, GyroSpaceCurveFunc func,
+                                                   void* userData, float maxSpeed, float epsilon) {
+    if (!(maxSpeed > 0.0f))
+        maxSpeed = 1.0f;
+    curve->maxSpeed = maxSpeed;
+
+    for (uint32_t intervals = 16; ; intervals *= 2) {
+        if (intervals > GYROSPACE_CURVE_MAX_INTERVALS)
+            intervals = GYROSPACE_CURVE_MAX_INTERVALS;
+
+        float step = maxSpeed / (float)intervals;
+        for (uint32_t i = 0; i <= intervals; ++i)
+            curve->values[i] = func((float)i * step, userData);
+
+        // Check each interval at its quarter points against the analytic curve
+        float maxError = 0.0f;
+        for (uint32_t i = 0; i < intervals; ++i) {
+            for (int k = 1; k < 4; ++k) {
+                float t = (float)k * 0.25f;
+                float approx = curve->values[i] + (curve->values[i + 1] - curve->values[i]) * t;
+                float error = fabsf(approx - func(((float)i + t) * step, userData));
+                if (error > maxError) maxError = error;
+            }
+        }
+
+        curve->intervals = intervals;
+        curve->invStep = (float)intervals / maxSpeed;
+        curve->maxError = maxError;
+
+        if (maxError <= epsilon)
+            return true;
+        if (intervals == GYROSPACE_CURVE_MAX_INTERVALS)
+            return false;
+    }
+}
+
+/** Returns the sensitivity multiplier for an angular speed. */
+static inline float GyroSpace_EvalSensitivityCurve(const GyroSpaceSensitivityCurve* curve, float speed) {
+    float pos = speed * curve->invStep;
+    // Written so NaN lands on 0: converting NaN or an out-of-range float to uint32_t is undefined
+    if (!(pos > 0.0f))
+        pos = 0.0f;
+    if (pos > (float)curve->intervals)
+        pos = (float)curve->intervals;
+    uint32_t i = (uint32_t)pos;
+    if (i >= curve->intervals)
+        return curve->values[curve->intervals];
+    float t = pos - (float)i;
+    return curve->values[i] + (curve->values[i + 1] - curve->values[i]) * t;
+}
+
+/** Scales a transformed gyro vector by the curve evaluated at its speed. */
+static inline Vector3 GyroSpace_ApplySensitivityCurve(const GyroSpaceSensitivityCurve* curve, Vector3 v) {
+    return Vec3_Scale(v, GyroSpace_EvalSensitivityCurve(curve, Vec3_Magnitude(v)));
+}
+
+/**
+ * Applies the curve to count samples stored as SoA arrays, matching the batch
+ * transform API. Output arrays may be the same as the inputs. Speeds and
+ * scaling run four samples at a time with SSE; the table reads are scalar.
+ */
+static inline void GyroSpace_ApplySensitivityCurveBatch(const GyroSpaceSensitivityCurve* curve,
+                                                        const float* inX, const float* inY, const float* inZ,
+                                                        float* outX, float* outY, float* outZ, size_t count) {
+    size_t i = 0;
+#if GYROSPACE_SSE
+    const __m128 invStep = _mm_set1_ps(curve->invStep);
+    const __m128 maxPos = _mm_set1_ps((float)curve->intervals);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(inX + i);
+        __m128 y = _mm_loadu_ps(inY + i);
+        __m128 z = _mm_loadu_ps(inZ + i);
+        __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        __m128 pos = _mm_min_ps(_mm_mul_ps(speed, invStep), maxPos);
+
+        GYROSPACE_ALIGN(16) float p[4];
+        GYROSPACE_ALIGN(16) float lo[4];
+        GYROSPACE_ALIGN(16) float hi[4];
+        GYROSPACE_ALIGN(16) float base[4];
+        _mm_store_ps(p, pos);
+        for (int k = 0; k < 4; ++k) {
+            uint32_t idx = (uint32_t)p[k];
+            if (idx >= curve->intervals) idx = curve->intervals - 1;
+            base[k] = (float)idx;
+            lo[k] = curve->values[idx];
+            hi[k] = curve->values[idx + 1];
+        }
+
+        __m128 vlo = _mm_load_ps(lo);
+        __m128 t = _mm_sub_ps(pos, _mm_load_ps(base));
+        __m128 scale = _mm_add_ps(vlo, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(hi), vlo), t));
+        _mm_storeu_ps(outX + i, _mm_mul_ps(x, scale));
+        _mm_storeu_ps(outY + i, _mm_mul_ps(y, scale));
+        _mm_storeu_ps(outZ + i, _mm_mul_ps(z, scale));
+    }
+#endif
+    for (; i < count; ++i) {
+        Vector3 out = GyroSpace_ApplySensitivityCurve(curve, Vec3_New(inX[i], inY[i], inZ[i]));
+        outX[i] = out.x;
+        outY[i] = out.y;
+        outZ[i] = out.z;
+    }
+}
+
+// Flick Stick
+
+/** Samples averaged when smoothing small stick rotations. */
+#ifndef GYROSPACE_FLICK_SMOOTH_WINDOW
+    #define GYROSPACE_FLICK_SMOOTH_WINDOW 16
+#endif
+
+/**
+ * Flick stick, as in JoyShockMapper and Fortnite's Gyro Aim/Flick Stick.
+ *
+ * Pushing the stick past the flick threshold turns the camera to face that
+ * direction over flickTime seconds. While the stick stays pushed, rotating it
+ * turns the camera by the same angle; small rotations are smoothed over a
+ * short window to hide stick noise. The output is a yaw delta in degrees for
+ * the update, which adds directly onto integrated Player Space yaw.
+ */
+typedef struct {
+    float flickThreshold;      // Stick deflection (0..1) that starts a flick
+    float flickTime;           // Seconds to complete a flick animation
+    float smoothThreshold;     // Rotation per update (radians) below which rotation is fully smoothed
+
+    bool active;               // Stick is past the threshold
+    float lastAngle;           // Stick angle at the previous update (radians)
+    float flickTarget;         // Angle of the current flick animation (radians)
+    float flickProgress;       // Seconds into the current flick animation
+
+    float smoothBuffer[GYROSPACE_FLICK_SMOOTH_WINDOW];
+    double smoothSum;          // Running window sum; double so add/remove rounding does not build up
+    uint32_t smoothHead;
+} GyroSpaceFlickStick;
+
+/** Initializes flick stick state. Typical values: 0.9 threshold, 0.1 s flick time, 0.05 rad smoothing. */
+static inline void GyroSpace_InitFlickStick(GyroSpaceFlickStick* fs, float flickThreshold, float flickTime, float smoothThreshold) {
+    fs->flickThreshold = flickThreshold;
+    fs->flickTime = flickTime;
+    fs->smoothThreshold = smoothThreshold;
+    fs->active = false;
+    fs->lastAngle = 0.0f;
+    fs->flickTarget = 0.0f;
+    fs->flickProgress = 0.0f;
+    for (int i = 0; i < GYROSPACE_FLICK_SMOOTH_WINDOW; ++i)
+        fs->smoothBuffer[i] = 0.0f;
+    fs->smoothSum = 0.0;
+    fs->smoothHead = 0;
+}
+
+/** Quadratic ease-out used by the flick animation. */
+static inline float GyroSpace_FlickEase(float t) {
+    float u = 1.0f - t;
+    return 1.0f - u * u;
+}
+
+/** Tiered smoothing of a stick rotation step: small steps are averaged, large ones pass through. */
+static inline float GyroSpace_FlickSmoothRotation(GyroSpaceFlickStick* fs, float delta) {
+    float directWeight = (fs->smoothThreshold > 0.0f) ? clamp(fabsf(delta) / fs->smoothThreshold - 1.0f, 0.0f, 1.0f) : 1.0f;
+    float smoothIn = delta * (1.0f - directWeight);
+
+    fs->smoothSum += (double)smoothIn - (double)fs->smoothBuffer[fs->smoothHead];
+    fs->smoothBuffer[fs->smoothHead] = smoothIn;
+    fs->smoothHead = (fs->smoothHead + 1) % GYROSPACE_FLICK_SMOOTH_WINDOW;
+
+    return delta * directWeight + (float)(fs->smoothSum * (1.0 / GYROSPACE_FLICK_SMOOTH_WINDOW));
+}
+
+/**
+ * Advances the flick stick by deltaTime seconds.
+ * stickX is positive to the right and stickY positive forward (negate SDL's
+ * Y axis). Returns the yaw change in degrees for this update, positive when
+ * turning right.
+ */
+static inline float GyroSpace_UpdateFlickStick(GyroSpaceFlickStick* fs, float stickX, float stickY, float deltaTime) {
+    float output = 0.0f;
+    float deflection = sqrtf(stickX * stickX + stickY * stickY);
+
+    if (deflection >= fs->flickThreshold) {
+        // 0 = forward, positive = clockwise
+        float angle = GyroSpace_FastAtan2(stickX, stickY);
+        if (!fs->active) {
+            // Rotation the previous flick has not applied yet carries into the new one
+            float remaining = 0.0f;
+            if (fs->flickTarget != 0.0f && fs->flickTime > 0.0f)
+                remaining = fs->flickTarget * (1.0f - GyroSpace_FlickEase(fminf(fs->flickProgress / fs->flickTime, 1.0f)));
+            fs->active = true;
+            fs->flickTarget = angle + remaining;
+            fs->flickProgress = 0.0f;
+        } else {
+            output += GyroSpace_FlickSmoothRotation(fs, GyroSpace_WrapAngle(angle - fs->lastAngle));
+        }
+        fs->lastAngle = angle;
+    } else if (fs->active) {
+        // Released: drop any smoothed rotation still queued
+        fs->active = false;
+        for (int i = 0; i < GYROSPACE_FLICK_SMOOTH_WINDOW; ++i)
+            fs->smoothBuffer[i] = 0.0f;
+        fs->smoothSum = 0.0;
+    }
+
+    // Flick animation keeps running after release until it completes
+    if (fs->flickTarget != 0.0f) {
+        float t0 = (fs->flickTime > 0.0f) ? fs->flickProgress / fs->flickTime : 1.0f;
+        fs->flickProgress += deltaTime;
+        float t1 = (fs->flickTime > 0.0f) ? fminf(fs->flickProgress / fs->flickTime, 1.0f) : 1.0f;
+        output += fs->flickTarget * (GyroSpace_FlickEase(t1) - GyroSpace_FlickEase(fminf(t0, 1.0f)));
+        if (t1 >= 1.0f)
+            fs->flickTarget = 0.0f;
+    }
+
+    return output * GYROSPACE_RAD_TO_DEG;
+}
+
+/**
+ * Returns the combined yaw change in degrees for this update: Player Space
+ * gyro yaw (playerGyro.x, in degrees per second) integrated over deltaTime,
+ * plus the flick stick output.
+ */
+static inline float GyroSpace_FlickStickPlayerYaw(GyroSpaceFlickStick* fs, Vector3 playerGyro,
+                                                  float stickX, float stickY, float deltaTime) {
+    return playerGyro.x * deltaTime + GyroSpace_UpdateFlickStick(fs, stickX, stickY, deltaTime);
+}
+
+// Latency Prediction
+
+/** Largest number of recent samples a predictor fits over. */
+#ifndef GYROSPACE_PREDICT_MAX_WINDOW
+    #define GYROSPACE_PREDICT_MAX_WINDOW 8
+#endif
+
+typedef enum {
+    GYROSPACE_PREDICT_LINEAR = 0,    // Least-squares line: extrapolates angular acceleration
+    GYROSPACE_PREDICT_QUADRATIC = 1  // Least-squares parabola: also follows changing acceleration
+} GyroSpacePredictMode;
+
+/**
+ * Extrapolates transformed angular velocity to a display timestamp to hide
+ * the 5-20 ms between sampling and photons.
+ *
+ * Keeps only the last few samples in a fixed ring; a query fits them and
+ * evaluates the fit at the target time, so its cost is bounded by the
+ * window size. Predictions are clamped so a flick that is stopping does not
+ * overshoot: the lead time is capped, no axis may exceed overshootFactor
+ * times its largest recent speed, and no axis may cross zero when the
+ * latest sample has not.
+ */
+typedef struct {
+    uint64_t times[GYROSPACE_PREDICT_MAX_WINDOW];   // Microseconds
+    Vector3 values[GYROSPACE_PREDICT_MAX_WINDOW];
+    uint32_t window;
+    uint32_t head;        // Slot of the next sample
+    uint32_t count;
+    GyroSpacePredictMode mode;
+    float maxLeadTime;    // Seconds
+    float overshootFactor;
+} GyroSpacePredictor;
+
+/**
+ * Initializes a predictor. window is clamped to [2, GYROSPACE_PREDICT_MAX_WINDOW]
+ * (quadratic fits need at least 3 samples and fall back to linear until
+ * then). Typical values: 4-6 samples, 0.02 s lead, 1.25 overshoot factor.
+ */
+static inline void GyroSpace_InitPredictor(GyroSpacePredictor* p, GyroSpacePredictMode mode, uint32_t window,
+                                           float maxLeadTime, float overshootFactor) {
+    if (window < 2) window = 2;
+    if (window > GYROSPACE_PREDICT_MAX_WINDOW) window = GYROSPACE_PREDICT_MAX_WINDOW;
+    p->window = window;
+    p->head = 0;
+    p->count = 0;
+    p->mode = mode;
+    p->maxLeadTime = fmaxf(maxLeadTime, 0.0f);
+    p->overshootFactor = fmaxf(overshootFactor, 0.0f);
+}
+
+/** Adds a transformed sample taken at timestampUs (microseconds, increasing). */
+static inline void GyroSpace_PredictorPush(GyroSpacePredictor* p, uint64_t timestampUs, Vector3 value) {
+    p->times[p->head] = timestampUs;
+    p->values[p->head] = value;
+    p->head = (p->head + 1 == p->window) ? 0 : p->head + 1;
+    if (p->count < p->window)
+        p->count++;
+}
+
+/** Clamps one predicted axis against the recent samples (see GyroSpacePredictor). */
+static inline float GyroSpace_ClampPrediction(float predicted, float latest, float peak, float overshootFactor) {
+    float limit = peak * overshootFactor;
+    predicted = clamp(predicted, -limit, limit);
+    if ((latest >= 0.0f && predicted < 0.0f) || (latest <= 0.0f && predicted > 0.0f))
+        predicted = 0.0f;
+    return predicted;
+}
+
+/** Returns the predicted value at targetUs (microseconds). */
+static inline Vector3 GyroSpace_Predict(const GyroSpacePredictor* p, uint64_t targetUs) {
+    if (p->count == 0)
+        return Vec3_New(0.0f, 0.0f, 0.0f);
+
+    uint32_t latestSlot = (p->head + p->window - 1) % p->window;
+    uint64_t latestTime = p->times[latestSlot];
+    Vector3 latest = p->values[latestSlot];
+    if (p->count < 2)
+        return latest;
+
+    // Times are in milliseconds relative to the latest sample. The fit is
+    // done in double: the quadratic normal equations lose about three
+    // digits to cancellation, which is 1e-3 of the peak speed in float
+    double lead = (targetUs > latestTime) ? (double)(targetUs - latestTime) * 1e-3 : 0.0;
+    lead = fmin(lead, (double)p->maxLeadTime * 1000.0);
+
+    Vector3 peak = Vec3_New(0.0f, 0.0f, 0.0f);
+    double st = 0.0, st2 = 0.0, st3 = 0.0, st4 = 0.0;
+    double sy[3] = { 0.0, 0.0, 0.0 }, sty[3] = { 0.0, 0.0, 0.0 }, st2y[3] = { 0.0, 0.0, 0.0 };
+    const double n = (double)p->count;
+
+    for (uint32_t i = 0; i < p->count; ++i) {
+        uint32_t slot = (latestSlot + p->window - i) % p->window;
+        Vector3 v = p->values[slot];
+        const float* y = &v.x;
+        double ti = -(double)(latestTime - p->times[slot]) * 1e-3;
+        double ti2 = ti * ti;
+        st += ti; st2 += ti2; st3 += ti2 * ti; st4 += ti2 * ti2;
+        for (int axis = 0; axis < 3; ++axis) {
+            sy[axis] += y[axis];
+            sty[axis] += y[axis] * ti;
+            st2y[axis] += y[axis] * ti2;
+        }
+        peak = Vec3_New(fmaxf(peak.x, fabsf(v.x)), fmaxf(peak.y, fabsf(v.y)), fmaxf(peak.z, fabsf(v.z)));
+    }
+
+    Vector3 predicted = latest;
+    float* out = &predicted.x;
+    bool solved = false;
+
+    if (p->mode == GYROSPACE_PREDICT_QUADRATIC && p->count >= 3) {
+        // Normal equations for y = a + b*t + c*t^2, solved by Cramer's rule
+        double m00 = n, m01 = st, m02 = st2, m11 = st2, m12 = st3, m22 = st4;
+        double c00 = m11 * m22 - m12 * m12;
+        double c01 = m02 * m12 - m01 * m22;
+        double c02 = m01 * m12 - m02 * m11;
+        double det = m00 * c00 + m01 * c01 + m02 * c02;
+        if (fabs(det) > 1e-6) {
+            double c11 = m00 * m22 - m02 * m02;
+            double c12 = m01 * m02 - m00 * m12;
+            double c22 = m00 * m11 - m01 * m01;
+            double invDet = 1.0 / det;
+            for (int axis = 0; axis < 3; ++axis) {
+                double a = (c00 * sy[axis] + c01 * sty[axis] + c02 * st2y[axis]) * invDet;
+                double b = (c01 * sy[axis] + c11 * sty[axis] + c12 * st2y[axis]) * invDet;
+                double c = (c02 * sy[axis] + c12 * sty[axis] + c22 * st2y[axis]) * invDet;
+                out[axis] = (float)(a + (b + c * lead) * lead);
+            }
+            solved = true;
+        }
+    }
+
+    if (!solved) {
+        // Least-squares line through the window
+        double varT = st2 - st * st / n;
+        if (varT > 1e-6) {
+            double meanT = st / n;
+            for (int axis = 0; axis < 3; ++axis) {
+                double slope = (sty[axis] - sy[axis] * meanT) / varT;
+                out[axis] = (float)(sy[axis] / n + slope * (lead - meanT));
+            }
+        }
+    }
+
+    return Vec3_New(GyroSpace_ClampPrediction(predicted.x, latest.x, peak.x, p->overshootFactor),
+                    GyroSpace_ClampPrediction(predicted.y, latest.y, peak.y, p->overshootFactor),
+                    GyroSpace_ClampPrediction(predicted.z, latest.z, peak.z, p->overshootFactor));
+}
+
+// Resampling
+
+/** Input samples a resampler remembers; must be a power of two. */
+#ifndef GYROSPACE_RESAMPLE_HISTORY
+    #define GYROSPACE_RESAMPLE_HISTORY 128
+#endif
+
+/** Entries in the precomputed half-kernel table. */
+#ifndef GYROSPACE_RESAMPLE_TABLE_SIZE
+    #define GYROSPACE_RESAMPLE_TABLE_SIZE 256
+#endif
+
+typedef enum {
+    GYROSPACE_RESAMPLE_LINEAR = 0,  // Interpolate between the two bracketing samples
+    GYROSPACE_RESAMPLE_SINC = 1     // Blackman-windowed sinc low-pass, band-limited to the slower rate
+} GyroSpaceResampleMode;
+
+/**
+ * Converts timestamped transform outputs from the device rate (833 Hz Switch
+ * Pro, 1000 Hz DualSense, irregular Bluetooth) to a fixed target clock such
+ * as a 500 Hz physics tick.
+ *
+ * The sinc kernel is precomputed into a table over its half-width, and each
+ * output sums the table-weighted inputs inside the kernel window, so the
+ * cost per output is proportional to the tap count. Weights are normalized
+ * per output, which keeps the gain right when input timing jitters. Sinc
+ * output lags the input by the kernel half-width.
+ */
+typedef struct {
+    GyroSpaceResampleMode mode;
+    double outputPeriodUs;
+    uint64_t originUs;        // Time of output 0 (first input sample)
+    uint64_t outputIndex;     // Next output to produce
+    float halfWidthUs;        // Kernel reaches zero this far from the output time
+    float tableScale;         // GYROSPACE_RESAMPLE_TABLE_SIZE / halfWidthUs
+    float kernel[GYROSPACE_RESAMPLE_TABLE_SIZE + 1];
+
+    uint64_t times[GYROSPACE_RESAMPLE_HISTORY];
+    Vector3 values[GYROSPACE_RESAMPLE_HISTORY];
+    uint64_t pushed;          // Total inputs; input i lives at i & (HISTORY - 1)
+    uint64_t searchFrom;      // First input that can still affect the next output
+} GyroSpaceResampler;
+
+/**
+ * Initializes a resampler. inputRate is the nominal device rate and
+ * outputRate the target clock, both in Hz. For sinc mode, zeroCrossings is
+ * the number of sinc lobes on each side (taps = 2 * zeroCrossings at the
+ * slower rate; 4-8 is typical). The kernel window must fit in
+ * GYROSPACE_RESAMPLE_HISTORY input samples.
+ */
+static inline void GyroSpace_InitResampler(GyroSpaceResampler* r, GyroSpaceResampleMode mode,
+                                           float inputRate, float outputRate, uint32_t zeroCrossings) {
+    r->mode = mode;
+    r->outputPeriodUs = 1e6 / (double)outputRate;
+    r->originUs = 0;
+    r->outputIndex = 0;
+    r->pushed = 0;
+    r->searchFrom = 0;
+
+    // Cut off a little below the Nyquist rate of the slower clock
+    float cutoff = 0.45f * fminf(inputRate, outputRate);
+    if (zeroCrossings < 1) zeroCrossings = 1;
+    r->halfWidthUs = (float)zeroCrossings / (2.0f * cutoff) * 1e6f;
+    r->tableScale = (float)GYROSPACE_RESAMPLE_TABLE_SIZE / r->halfWidthUs;
+
+    for (int i = 0; i <= GYROSPACE_RESAMPLE_TABLE_SIZE; ++i) {
+#ifdef GYROSPACE_DETERMINISTIC
+        // Header polynomials instead of libm, so the table is the same on every platform
+        float x = (float)i / GYROSPACE_RESAMPLE_TABLE_SIZE;     // 0..1 of the half-width
+        float arg = GYROSPACE_PI * x * (float)zeroCrossings;   // pi * 2 * cutoff * t
+        float sinArg, cosArg, sinWin, cosWin;
+        GyroSpace_FastSinCos(arg, &sinArg, &cosArg);
+        GyroSpace_FastSinCos(GYROSPACE_PI * x, &sinWin, &cosWin);
+        float sinc = (i == 0) ? 1.0f : sinArg / arg;
+        float window = 0.42f + 0.5f * cosWin + 0.08f * (2.0f * cosWin * cosWin - 1.0f);
+        r->kernel[i] = sinc * window;
+#else
+        double x = (double)i / GYROSPACE_RESAMPLE_TABLE_SIZE;          // 0..1 of the half-width
+        double arg = 3.14159265358979 * x * (double)zeroCrossings;    // pi * 2 * cutoff * t
+        double sinc = (i == 0) ? 1.0 : sin(arg) / arg;
+        double window = 0.42 + 0.5 * cos(3.14159265358979 * x) + 0.08 * cos(2.0 * 3.14159265358979 * x);
+        r->kernel[i] = (float)(sinc * window);
+#endif
+    }
+}
+
+/** Adds an input sample. Timestamps are microseconds and must not decrease. */
+static inline void GyroSpace_ResamplerPush(GyroSpaceResampler* r, uint64_t timestampUs, Vector3 value) {
+    if (r->pushed == 0)
+        r->originUs = timestampUs;
+
+    uint32_t slot = (uint32_t)(r->pushed & (GYROSPACE_RESAMPLE_HISTORY - 1));
+    r->times[slot] = timestampUs;
+    r->values[slot] = value;
+    r->pushed++;
+
+    // Inputs that fell out of the history can no longer be used
+    if (r->pushed - r->searchFrom > GYROSPACE_RESAMPLE_HISTORY)
+        r->searchFrom = r->pushed - GYROSPACE_RESAMPLE_HISTORY;
+}
+
+/** Kernel weight for a time offset in microseconds. */
+static inline float GyroSpace_ResampleKernel(const GyroSpaceResampler* r, float offsetUs) {
+    float pos = fabsf(offsetUs) * r->tableScale;
+    if (!(pos < (float)GYROSPACE_RESAMPLE_TABLE_SIZE)) // Also rejects NaN before the integer conversion
+        return 0.0f;
+    uint32_t i = (uint32_t)pos;
+    float t = pos - (float)i;
+    return r->kernel[i] + (r->kernel[i + 1] - r->kernel[i]) * t;
+}
+
+/**
+ * Produces the next output sample on the target clock if enough input has
+ * arrived. Returns false when more input is needed. Call repeatedly after
+ * each push until it returns false.
+ */
+static inline bool GyroSpace_ResamplerPop(GyroSpaceResampler* r, uint64_t* outTimeUs, Vector3* out) {
+    if (r->pushed == 0)
+        return false;
+
+    uint64_t target = r->originUs + (uint64_t)((double)r->outputIndex * r->outputPeriodUs + 0.5);
+    uint64_t newestTime = r->times[(r->pushed - 1) & (GYROSPACE_RESAMPLE_HISTORY - 1)];
+    const uint64_t mask = GYROSPACE_RESAMPLE_HISTORY - 1;
+
+    if (r->mode == GYROSPACE_RESAMPLE_LINEAR) {
+        if (newestTime < target)
+            return false;
+
+        // Advance to the last input at or before the target
+        while (r->searchFrom + 1 < r->pushed && r->times[(r->searchFrom + 1) & mask] <= target)
+            r->searchFrom++;
+
+        uint64_t t0 = r->times[r->searchFrom & mask];
+        Vector3 v0 = r->values[r->searchFrom & mask];
+        if (r->searchFrom + 1 < r->pushed && target > t0) {
+            uint64_t t1 = r->times[(r->searchFrom + 1) & mask];
+            float frac = (t1 > t0) ? (float)(target - t0) / (float)(t1 - t0) : 0.0f;
+            *out = Vec3_Lerp(v0, r->values[(r->searchFrom + 1) & mask], frac);
+        } else {
+            *out = v0;
+        }
+    } else {
+        uint64_t halfWidth = (uint64_t)r->halfWidthUs;
+        if (newestTime < target + halfWidth)
+            return false;
+
+        // Skip inputs left of the kernel window
+        while (r->searchFrom + 1 < r->pushed && r->times[r->searchFrom & mask] + halfWidth < target)
+            r->searchFrom++;
+
+        Vector3 sum = Vec3_New(0.0f, 0.0f, 0.0f);
+        float weightSum = 0.0f;
+        for (uint64_t i = r->searchFrom; i < r->pushed; ++i) {
+            uint64_t t = r->times[i & mask];
+            if (t > target + halfWidth)
+                break;
+            float w = GyroSpace_ResampleKernel(r, (float)((int64_t)(t - target)));
+            sum = Vec3_Add(sum, Vec3_Scale(r->values[i & mask], w));
+            weightSum += w;
+        }
+
+        // No input near the target (e.g. a dropout): hold the nearest sample
+        *out = (fabsf(weightSum) > EPSILON) ? Vec3_Scale(sum, 1.0f / weightSum) : r->values[r->searchFrom & mask];
+    }
+
+    *outTimeUs = target;
+    r->outputIndex++;
+    return true;
+}
+
+// Shadow Accuracy Monitor
+
+/** Default reference interval: one check per 1024 samples. */
+#ifndef GYROSPACE_SHADOW_INTERVAL
+    #define GYROSPACE_SHADOW_INTERVAL 1024
+#endif
+
+/**
+ * Shadow mode for SIMD, fast-math or other optimized builds: every Nth
+ * sample, the scalar double-precision reference of the active
+ * TransformTo*Space runs on the same input and the deviation of the
+ * production output is recorded. Skipped samples cost one counter
+ * decrement; tests/shadow_monitor.c measures the overhead at the default
+ * interval.
+ */
+typedef struct {
+    GyroSpaceTransformSpace space;
+    float couplingFactor;     // Local Space coupling, as passed to TransformToLocalSpace
+    float tolerance;          // Deviations above this are counted in exceedances
+    uint32_t interval;        // Check every interval-th sample (0 disables)
+    uint32_t countdown;
+
+    uint64_t checks;
+    uint64_t exceedances;
+    double maxDeviation;      // Largest per-axis |output - reference| seen
+    double sumDeviation;      // Sum of per-check maxima, for the mean
+    Vector3 worstInput;       // (yaw, pitch, roll) that produced maxDeviation
+} GyroSpaceShadowMonitor;
+
+/** Initializes a monitor for one transform space. interval 0 disables checking. */
+static inline void GyroSpace_InitShadowMonitor(GyroSpaceShadowMonitor* mon, GyroSpaceTransformSpace space,
+                                               float couplingFactor, uint32_t interval, float tolerance) {
+    mon->space = space;
+    mon->couplingFactor = couplingFactor;
+    mon->tolerance = tolerance;
+    mon->interval = interval;
+    mon->countdown = interval ? interval : UINT32_MAX;
+    mon->checks = 0;
+    mon->exceedances = 0;
+    mon->maxDeviation = 0.0;
+    mon->sumDeviation = 0.0;
+    mon->worstInput = Vec3_New(0.0f, 0.0f, 0.0f);
+}
+
+/**
+ * Double-precision reference of TransformToLocalSpace, TransformToPlayerSpace
+ * and TransformToWorldSpace. gravity is the gravity vector the production
+ * call used (the global or context gravNorm).
+ */
+static inline void GyroSpace_ShadowReference(GyroSpaceTransformSpace space, double couplingFactor, Vector3 gravity,
+                                             double yaw, double pitch, double roll, double out[3]) {
+    switch (space) {
+    case GYROSPACE_SPACE_LOCAL: {
+        double adjustedRoll = roll * 0.85 - yaw * couplingFactor;
+        out[0] = yaw - adjustedRoll;
+        out[1] = pitch;
+        out[2] = adjustedRoll;
+        break;
+    }
+    case GYROSPACE_SPACE_PLAYER: {
+        double worldYaw = yaw * (double)gravity.y + roll * (double)gravity.z;
+        double combinedYawRoll = sqrt(yaw * yaw + roll * roll);
+        double adjustedYaw = fmin(fabs(worldYaw) * 2.0, combinedYawRoll);
+        out[0] = (worldYaw >= 0.0) ? adjustedYaw : -adjustedYaw;
+        out[1] = pitch;
+        out[2] = 0.0;
+        break;
+    }
+    default: {
+        double g[3] = { gravity.x, gravity.y, gravity.z };
+        double n = sqrt(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+        for (int i = 0; i < 3; ++i) g[i] /= n;
+
+        double f[3] = { 0.0, 0.0, 1.0 };
+        if (fabs(g[2]) > 0.99) { f[0] = 1.0; f[2] = 0.0; }
+
+        // right = normalize(g x f), forward = normalize(right x g)
+        double r[3] = { g[1] * f[2] - g[2] * f[1], g[2] * f[0] - g[0] * f[2], g[0] * f[1] - g[1] * f[0] };
+        n = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+        for (int i = 0; i < 3; ++i) r[i] /= n;
+        double p[3] = { r[1] * g[2] - r[2] * g[1], r[2] * g[0] - r[0] * g[2], r[0] * g[1] - r[1] * g[0] };
+        n = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        for (int i = 0; i < 3; ++i) p[i] /= n;
+
+        out[0] = r[0] * yaw + r[1] * pitch + r[2] * roll;
+        out[1] = g[0] * yaw + g[1] * pitch + g[2] * roll;
+        out[2] = p[0] * yaw + p[1] * pitch + p[2] * roll;
+        break;
+    }
+    }
+}
+
+/** Runs the reference on one sample and records how far output deviates from it. */
+static inline void GyroSpace_ShadowCompare(GyroSpaceShadowMonitor* mon, Vector3 gravity,
+                                           float yaw, float pitch, float roll, Vector3 output) {
+    double ref[3];
+    GyroSpace_ShadowReference(mon->space, mon->couplingFactor, gravity, yaw, pitch, roll, ref);
+    double deviation = fmax(fabs((double)output.x - ref[0]), fmax(fabs((double)output.y - ref[1]), fabs((double)output.z - ref[2])));
+
+    mon->checks++;
+    mon->sumDeviation += deviation;
+    if (deviation > (double)mon->tolerance)
+        mon->exceedances++;
+    if (deviation > mon->maxDeviation) {
+        mon->maxDeviation = deviation;
+        mon->worstInput = Vec3_New(yaw, pitch, roll);
+    }
+}
+
+/**
+ * Call after each production transform with its input and output. Every
+ * interval-th call runs the reference; the rest only count down.
+ */
+static inline void GyroSpace_ShadowSample(GyroSpaceShadowMonitor* mon, Vector3 gravity,
+                                          float yaw, float pitch, float roll, Vector3 output) {
+    if (--mon->countdown != 0)
+        return;
+    if (mon->interval == 0) {
+        mon->countdown = UINT32_MAX;
+        return;
+    }
+    mon->countdown = mon->interval;
+    GyroSpace_ShadowCompare(mon, gravity, yaw, pitch, roll, output);
+}
+
+/** Mean of the per-check deviations, or 0 before the first check. */
+static inline double GyroSpace_ShadowMeanDeviation(const GyroSpaceShadowMonitor* mon) {
+    return mon->checks ? mon->sumDeviation / (double)mon->checks : 0.0;
+}
+
 #ifdef __cplusplus
 }
 #endif
+
+#ifdef GYROSPACE_DETERMINISTIC
+    #if defined(__clang__)
+        #pragma STDC FP_CONTRACT DEFAULT
+    #elif defined(_MSC_VER)
+        #pragma fp_contract(on)
+    #endif
+#endif
  
 #endif // GYROSPACE_HPP
\ No newline at end of file
@@ -0,0 +1,328 @@
+/*
+ * =======================================================================
+ *
+ * Gyro Space to Play - C++ Helpers
+ *
+ * Optional C++ companion to GyroSpace.h. Everything lives in the
+ * gyrospace namespace and is built on the C functions, so both APIs can
+ * be mixed freely.
+ *
+ * sample_stream (C++20 coroutines) hands transformed samples from the
+ * input side to game logic: the producer pushes samples into a ring
+ * buffer and flushes once per device read, which resumes the waiting
+ * coroutine inline on the producer's thread with the whole batch. Game
+ * code can co_await the next batch or frame delta without polling or
+ * parking a thread.
+ *
+ * pipeline (C++17) chains processing stages - calibration, gravity update,
+ * space transform, smoothing, sensitivity curve, output scaling - into one
+ * loop per batch. Each sample passes through every stage while it is in
+ * registers, so no intermediate arrays are written.
+ *
+ * =======================================================================
+ */
+
+#ifndef GYROSPACE_CPP_HPP
+#define GYROSPACE_CPP_HPP
+
+#include "GyroSpace.h"
+
+#ifndef __cplusplus
+    #error "GyroSpaceCpp.h requires C++; use GyroSpace.h from C"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#if defined(_MSVC_LANG) && _MSVC_LANG > __cplusplus
+    #define GYROSPACE_CPLUSPLUS _MSVC_LANG
+#else
+    #define GYROSPACE_CPLUSPLUS __cplusplus
+#endif
+
+#if GYROSPACE_CPLUSPLUS >= 202002L && defined(__cpp_impl_coroutine)
+    #define GYROSPACE_COROUTINES 1
+    #include <coroutine>
+    #include <span>
+#else
+    #define GYROSPACE_COROUTINES 0
+#endif
+
+namespace gyrospace {
+
+/** A transformed gyro sample with its timestamp in microseconds. */
+struct sample {
+    uint64_t timestampUs;
+    Vector3 value;
+};
+
+/** Rotation accumulated over a batch: sum of value * dt, in the samples' units times seconds. */
+struct frame_delta {
+    Vector3 delta;
+    size_t samples;
+};
+
+// Sample Stream
+
+#if GYROSPACE_COROUTINES
+
+/**
+ * Single-producer, single-consumer handoff of samples to one coroutine.
+ *
+ * push() only stores; flush() resumes the waiting consumer inline, so the
+ * consumer runs on the producer's thread until its next co_await and no
+ * thread switch or lock is involved. Producer and consumer must therefore
+ * not run concurrently on different threads. When the ring is full the
+ * oldest sample is dropped and counted.
+ *
+ * Destroying the stream closes it first, so a parked consumer resumes with
+ * an empty batch while the stream is still alive; it must then stop using
+ * the stream.
+ */
+template <size_t Capacity = 256>
+class sample_stream {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    sample_stream() = default;
+    sample_stream(const sample_stream&) = delete;
+    sample_stream& operator=(const sample_stream&) = delete;
+    ~sample_stream() { close(); }
+
+    /** Stores a sample without waking the consumer. */
+    void push(uint64_t timestampUs, Vector3 value) {
+        if (tail_ - head_ == Capacity) {
+            ++head_;
+            ++dropped_;
+        }
+        ring_[tail_ & (Capacity - 1)] = sample{ timestampUs, value };
+        ++tail_;
+    }
+
+    /** Resumes the waiting consumer, if any, with everything pushed so far. */
+    void flush() {
+        if (waiter_ && (tail_ != head_ || closed_)) {
+            std::coroutine_handle<> h = waiter_;
+            waiter_ = nullptr;
+            h.resume();
+        }
+    }
+
+    /** Pushes count samples and flushes once. */
+    void publish(const sample* samples, size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            push(samples[i].timestampUs, samples[i].value);
+        flush();
+    }
+
+    /** Ends the stream; a waiting consumer resumes with an empty batch. */
+    void close() {
+        closed_ = true;
+        flush();
+    }
+
+    bool closed() const { return closed_ && tail_ == head_; }
+    uint64_t dropped() const { return dropped_; }
+
+    /** co_await next_batch() yields the pending samples (empty once the stream is closed). */
+    auto next_batch() {
+        struct awaiter {
+            sample_stream& s;
+            bool await_ready() const noexcept { return s.tail_ != s.head_ || s.closed_; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { s.waiter_ = h; }
+            std::span<const sample> await_resume() noexcept { return s.drain(); }
+        };
+        return awaiter{ *this };
+    }
+
+    /**
+     * co_await next_delta() yields the rotation integrated over the pending
+     * samples, using the gap to the previous sample as each one's dt.
+     */
+    auto next_delta() {
+        struct awaiter {
+            sample_stream& s;
+            bool await_ready() const noexcept { return s.tail_ != s.head_ || s.closed_; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { s.waiter_ = h; }
+            frame_delta await_resume() noexcept {
+                std::span<const sample> batch = s.drain();
+                frame_delta result{ Vec3_New(0.0f, 0.0f, 0.0f), batch.size() };
+                for (const sample& x : batch) {
+                    if (s.hasLast_ && x.timestampUs > s.lastTimestampUs_) {
+                        float dt = (float)(x.timestampUs - s.lastTimestampUs_) * 1e-6f;
+                        result.delta = Vec3_Add(result.delta, Vec3_Scale(x.value, dt));
+                    }
+                    s.lastTimestampUs_ = x.timestampUs;
+                    s.hasLast_ = true;
+                }
+                return result;
+            }
+        };
+        return awaiter{ *this };
+    }
+
+private:
+    /** Moves pending samples into the contiguous batch buffer. Valid until the next await. */
+    std::span<const sample> drain() {
+        size_t count = 0;
+        for (; head_ != tail_; ++head_)
+            batch_[count++] = ring_[head_ & (Capacity - 1)];
+        return std::span<const sample>(batch_.data(), count);
+    }
+
+    std::array<sample, Capacity> ring_{};
+    std::array<sample, Capacity> batch_{};
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t lastTimestampUs_ = 0;
+    std::coroutine_handle<> waiter_ = nullptr;
+    bool hasLast_ = false;    // lastTimestampUs_ is set; 0 is a valid timestamp
+    bool closed_ = false;
+};
+
+#endif // GYROSPACE_COROUTINES
+
+// Pipeline
+
+#if GYROSPACE_CPLUSPLUS >= 201703L
+
+/** Per-sample state passed through pipeline stages. */
+struct motion {
+    Vector3 gyro;        // (yaw, pitch, roll) until a space transform, then its output
+    Vector3 accel;       // Raw accel, for gravity stages
+    float deltaTime;     // Seconds since the previous sample
+};
+
+namespace stage {
+
+/** Subtracts a gyro bias (calibration offset). */
+struct calibrate {
+    Vector3 offset;
+    void operator()(motion& m) const { m.gyro = Vec3_Subtract(m.gyro, offset); }
+};
+
+/** Maps raw sensor axes to (yaw, pitch, roll) for the context's posture. */
+struct map_axes {
+    const GyroSpaceContext* ctx;
+    void operator()(motion& m) const { m.gyro = GyroSpace_MapSensorAxes(ctx, m.gyro); }
+};
+
+/** Updates the context gravity estimate under its gravity policy. Place before map_axes, while gyro is in sensor axes. */
+struct update_gravity {
+    GyroSpaceContext* ctx;
+    float fusionFactor;
+    void operator()(motion& m) const { GyroSpace_UpdateGravity(ctx, m.accel, m.gyro, fusionFactor, m.deltaTime); }
+};
+
+/** World Space through the context's cached matrix. */
+struct world_space {
+    const GyroSpaceContext* ctx;
+    void operator()(motion& m) const { m.gyro = GyroSpace_TransformToWorldSpace(ctx, m.gyro.x, m.gyro.y, m.gyro.z); }
+};
+
+/** Player Space against the context's gravity, so it follows update_gravity on the same context. */
+struct player_space {
+    const GyroSpaceContext* ctx;
+    void operator()(motion& m) const { m.gyro = GyroSpace_TransformToPlayerSpace(ctx, m.gyro.x, m.gyro.y, m.gyro.z); }
+};
+
+/** Local Space with the given yaw/roll coupling factor. Does not use gravity, so it needs no context. */
+struct local_space {
+    float couplingFactor;
+    void operator()(motion& m) const { m.gyro = TransformToLocalSpace(m.gyro.x, m.gyro.y, m.gyro.z, couplingFactor); }
+};
+
+struct one_euro {
+    GyroSpaceOneEuroFilter* filter;
+    void operator()(motion& m) const { m.gyro = GyroSpace_OneEuroFilter(filter, m.gyro); }
+};
+
+struct tiered_smooth {
+    GyroSpaceTieredSmoother* smoother;
+    void operator()(motion& m) const { m.gyro = GyroSpace_TieredSmooth(smoother, m.gyro); }
+};
+
+struct biquad {
+    GyroSpaceBiquad* filter;
+    void operator()(motion& m) const { m.gyro = GyroSpace_Biquad(filter, m.gyro); }
+};
+
+struct sensitivity_curve {
+    const GyroSpaceSensitivityCurve* curve;
+    void operator()(motion& m) const { m.gyro = GyroSpace_ApplySensitivityCurve(curve, m.gyro); }
+};
+
+/** Per-axis output scale, e.g. sensitivity and axis inversion. */
+struct scale {
+    Vector3 factor;
+    void operator()(motion& m) const { m.gyro = Vec3_New(m.gyro.x * factor.x, m.gyro.y * factor.y, m.gyro.z * factor.z); }
+};
+
+} // namespace stage
+
+/**
+ * Compile-time chain of stages. A stage is any callable taking motion&,
+ * including the ones in gyrospace::stage and lambdas, so new stages need
+ * no registration. Calls inline into a single loop; stages that hold
+ * filter state point at C structs the caller owns.
+ */
+template <typename... Stages>
+class pipeline {
+public:
+    explicit pipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    /** Runs every stage on one sample, in order. */
+    void process(motion& m) {
+        std::apply([&m](auto&... s) { (s(m), ...); }, stages_);
+    }
+
+    /**
+     * Runs the pipeline over count samples at a fixed deltaTime. Inputs and
+     * outputs are SoA arrays like the C batch API; accel arrays may be null
+     * when no stage uses them. Outputs may be the same as the gyro inputs.
+     */
+    void run(const float* gyroX, const float* gyroY, const float* gyroZ,
+             const float* accelX, const float* accelY, const float* accelZ, float deltaTime,
+             float* outX, float* outY, float* outZ, size_t count) {
+        const bool hasAccel = accelX != nullptr && accelY != nullptr && accelZ != nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            motion m;
+            m.gyro = Vec3_New(gyroX[i], gyroY[i], gyroZ[i]);
+            m.accel = hasAccel ? Vec3_New(accelX[i], accelY[i], accelZ[i]) : Vec3_New(0.0f, 0.0f, 0.0f);
+            m.deltaTime = deltaTime;
+            process(m);
+            outX[i] = m.gyro.x;
+            outY[i] = m.gyro.y;
+            outZ[i] = m.gyro.z;
+        }
+    }
+
+    /** Gyro-only overload of run(). */
+    void run(const float* gyroX, const float* gyroY, const float* gyroZ, float deltaTime,
+             float* outX, float* outY, float* outZ, size_t count) {
+        run(gyroX, gyroY, gyroZ, nullptr, nullptr, nullptr, deltaTime, outX, outY, outZ, count);
+    }
+
+    /** Access to a stage by index, e.g. to change a calibration offset. */
+    template <size_t I>
+    auto& get() { return std::get<I>(stages_); }
+
+private:
+    std::tuple<Stages...> stages_;
+};
+
+/** Builds a pipeline from stages: make_pipeline(stage::calibrate{...}, stage::world_space{&ctx}, ...). */
+template <typename... Stages>
+pipeline<Stages...> make_pipeline(Stages... stages) {
+    return pipeline<Stages...>(std::move(stages)...);
+}
+
+#endif // GYROSPACE_CPLUSPLUS >= 201703L
+
+} // namespace gyrospace
+
+#endif // GYROSPACE_CPP_HPP
@@ -0,0 +1,1012 @@
+/*
+ * =======================================================================
+ *
+ * Gyro Space to Play - Linux Input Backends
+ *
+ * Optional companion to GyroSpace.h for Linux. The kernel exposes a
+ * controller's motion sensors as their own evdev node (accel on
+ * ABS_X/Y/Z, gyro on ABS_RX/RY/RZ, hardware time on MSC_TIMESTAMP,
+ * flagged with INPUT_PROP_ACCELEROMETER). This backend reads those nodes
+ * in large input_event batches, multiplexes every device through one
+ * epoll set, assembles a complete sample on each SYN_REPORT and pushes it
+ * into the device's GyroSpaceContext.
+ *
+ * GyroSpaceEvdev_FeedEvents takes raw input_event arrays, so recorded
+ * event streams can be replayed without hardware.
+ *
+ * The uinput mouse sink goes the other way: it turns transformed gyro
+ * output into REL_X/REL_Y events on a virtual mouse, so GyroSpace.h can
+ * run as a system-wide remapper.
+ *
+ * GyroSpaceMem_CreateContextPool backs a GyroSpaceContextPool with huge
+ * pages for servers tracking many devices.
+ *
+ * The shared-memory channel publishes transformed samples from one
+ * processing daemon to several consumer processes without copies or
+ * sockets on the data path.
+ *
+ * Uses POSIX and GNU declarations, so build in the compiler's default
+ * gnu mode (or define _GNU_SOURCE) rather than strict -std=c99.
+ *
+ * =======================================================================
+ */
+
+#ifndef GYROSPACE_LINUX_HPP
+#define GYROSPACE_LINUX_HPP
+
+#include "GyroSpace.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <linux/memfd.h>
+#include <linux/uinput.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** input_event structs read per read() call. */
+#ifndef GYROSPACE_EVDEV_READ_BATCH
+    #define GYROSPACE_EVDEV_READ_BATCH 128
+#endif
+
+/** Per-sample accel weight the evdev backend passes to GyroSpace_UpdateGravity. */
+#ifndef GYROSPACE_EVDEV_GRAVITY_FUSION
+    #define GYROSPACE_EVDEV_GRAVITY_FUSION 0.02f
+#endif
+
+/** Devices one backend can multiplex. */
+#ifndef GYROSPACE_EVDEV_MAX_DEVICES
+    #define GYROSPACE_EVDEV_MAX_DEVICES 16
+#endif
+
+// Type Definitions
+
+/** One assembled motion sample, in deg/s and g. */
+typedef struct {
+    uint64_t timestamp;   // Microseconds (MSC_TIMESTAMP unwrapped, else event time)
+    Vector3 gyro;         // ABS_RX/RY/RZ
+    Vector3 accel;        // ABS_X/Y/Z
+} GyroSpaceMotionSample;
+
+/** Called once per assembled sample, after the context gravity has been updated under its policy. */
+typedef void (*GyroSpaceSampleCallback)(void* userData, GyroSpaceContext* ctx, const GyroSpaceMotionSample* sample);
+
+/** One evdev motion sensor node. */
+typedef struct {
+    int fd;
+    GyroSpaceContext* ctx;
+    GyroSpaceSampleCallback onSample;
+    void* userData;
+
+    float gyroScale;      // deg/s per count (1 / ABS_RX resolution)
+    float accelScale;     // g per count (1 / ABS_X resolution)
+    float gravityFusion;  // fusionFactor for GyroSpace_UpdateGravity
+
+    int32_t axes[6];      // Latest accel x/y/z, gyro x/y/z counts
+    uint32_t lastHardwareTime;
+    uint64_t hardwareTime;
+    bool hasHardwareTime;
+    uint64_t lastSampleTime; // Timestamp of the previous emitted sample
+    bool hasLastSample;
+    bool pending;         // Axis or timestamp events since the last SYN_REPORT
+    bool dropped;         // SYN_DROPPED seen; skip until the next SYN_REPORT, then resync
+} GyroSpaceEvdevDevice;
+
+/** epoll set over several motion sensor nodes. */
+typedef struct {
+    int epollFd;
+    GyroSpaceEvdevDevice* devices[GYROSPACE_EVDEV_MAX_DEVICES];
+    size_t deviceCount;
+} GyroSpaceEvdevBackend;
+
+// Event Assembly
+
+/**
+ * Prepares a device for GyroSpaceEvdev_FeedEvents without opening a node.
+ * gyroResolution and accelResolution are the evdev resolutions (counts per
+ * deg/s and counts per g). GyroSpaceEvdev_OpenDevice calls this itself.
+ */
+static inline void GyroSpaceEvdev_InitDevice(GyroSpaceEvdevDevice* dev, GyroSpaceContext* ctx,
+                                             int32_t gyroResolution, int32_t accelResolution,
+                                             GyroSpaceSampleCallback onSample, void* userData) {
+    dev->fd = -1;
+    dev->ctx = ctx;
+    dev->onSample = onSample;
+    dev->userData = userData;
+    dev->gyroScale = 1.0f / (float)(gyroResolution > 0 ? gyroResolution : 1);
+    dev->accelScale = 1.0f / (float)(accelResolution > 0 ? accelResolution : 1);
+    dev->gravityFusion = GYROSPACE_EVDEV_GRAVITY_FUSION;
+    for (int i = 0; i < 6; ++i)
+        dev->axes[i] = 0;
+    dev->lastHardwareTime = 0;
+    dev->hardwareTime = 0;
+    dev->hasHardwareTime = false;
+    dev->lastSampleTime = 0;
+    dev->hasLastSample = false;
+    dev->pending = false;
+    dev->dropped = false;
+}
+
+/**
+ * Emits the assembled sample on SYN_REPORT. The context gravity follows
+ * its policy through GyroSpace_UpdateGravity, with the time step taken
+ * from the sample timestamps (MSC_TIMESTAMP when the device sends it).
+ */
+static inline void GyroSpaceEvdev_EmitSample(GyroSpaceEvdevDevice* dev, const struct input_event* syn) {
+    GyroSpaceMotionSample sample;
+    sample.timestamp = dev->hasHardwareTime
+        ? dev->hardwareTime
+        : (uint64_t)syn->input_event_sec * 1000000u + (uint64_t)syn->input_event_usec;
+    sample.accel = Vec3_New((float)dev->axes[0] * dev->accelScale,
+                            (float)dev->axes[1] * dev->accelScale,
+                            (float)dev->axes[2] * dev->accelScale);
+    sample.gyro = Vec3_New((float)dev->axes[3] * dev->gyroScale,
+                           (float)dev->axes[4] * dev->gyroScale,
+                           (float)dev->axes[5] * dev->gyroScale);
+
+    float dt = dev->hasLastSample ? (float)(sample.timestamp - dev->lastSampleTime) * 1e-6f : 0.0f;
+    dev->lastSampleTime = sample.timestamp;
+    dev->hasLastSample = true;
+
+    if (dev->ctx)
+        GyroSpace_UpdateGravity(dev->ctx, sample.accel, sample.gyro, dev->gravityFusion, dt);
+    if (dev->onSample)
+        dev->onSample(dev->userData, dev->ctx, &sample);
+}
+
+/**
+ * Re-reads all six axes from the node with EVIOCGABS, replacing state that
+ * went stale when the kernel dropped events. Does nothing without an open
+ * node (replayed streams), where axes catch up as new events arrive.
+ */
+static inline void GyroSpaceEvdev_Resync(GyroSpaceEvdevDevice* dev) {
+    static const unsigned int codes[6] = { ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ };
+    if (dev->fd < 0)
+        return;
+
+    for (int i = 0; i < 6; ++i) {
+        struct input_absinfo info;
+        if (ioctl(dev->fd, EVIOCGABS(codes[i]), &info) == 0)
+            dev->axes[i] = info.value;
+    }
+}
+
+/**
+ * Feeds raw events (from read() or a recording) into the device.
+ * After SYN_DROPPED, events up to and including the next SYN_REPORT are
+ * discarded and the axes are resynced from the node, as the evdev
+ * protocol requires; no sample is emitted for that report.
+ * Returns the number of samples emitted.
+ */
+static inline size_t GyroSpaceEvdev_FeedEvents(GyroSpaceEvdevDevice* dev, const struct input_event* events, size_t count) {
+    size_t samples = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct input_event* ev = &events[i];
+
+        switch (ev->type) {
+        case EV_ABS:
+            if (ev->code <= ABS_Z)
+                dev->axes[ev->code - ABS_X] = ev->value;
+            else if (ev->code >= ABS_RX && ev->code <= ABS_RZ)
+                dev->axes[3 + ev->code - ABS_RX] = ev->value;
+            dev->pending = true;
+            break;
+
+        case EV_MSC:
+            if (ev->code == MSC_TIMESTAMP) {
+                // 32-bit microsecond counter; unwrap into 64 bits
+                uint32_t now = (uint32_t)ev->value;
+                dev->hardwareTime += dev->hasHardwareTime ? (uint32_t)(now - dev->lastHardwareTime) : now;
+                dev->lastHardwareTime = now;
+                dev->hasHardwareTime = true;
+                dev->pending = true;
+            }
+            break;
+
+        case EV_SYN:
+            if (ev->code == SYN_DROPPED) {
+                // Kernel buffer overran: axis state is stale until the next report
+                dev->dropped = true;
+            } else if (ev->code == SYN_REPORT) {
+                if (dev->dropped) {
+                    dev->dropped = false;
+                    GyroSpaceEvdev_Resync(dev);
+                } else if (dev->pending) {
+                    GyroSpaceEvdev_EmitSample(dev, ev);
+                    samples++;
+                }
+                dev->pending = false;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return samples;
+}
+
+// Device Nodes
+
+/** Returns true if fd is an evdev node flagged as a motion sensor. */
+static inline bool GyroSpaceEvdev_IsMotionSensor(int fd) {
+    unsigned long props[(INPUT_PROP_CNT + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long))] = { 0 };
+    if (ioctl(fd, EVIOCGPROP(sizeof(props)), props) < 0)
+        return false;
+    const size_t bits = 8 * sizeof(unsigned long);
+    return (props[INPUT_PROP_ACCELEROMETER / bits] >> (INPUT_PROP_ACCELEROMETER % bits)) & 1;
+}
+
+/**
+ * Opens a motion sensor node (e.g. /dev/input/event12) non-blocking and
+ * reads its axis resolutions. Returns false, with errno set, if the node
+ * cannot be opened or is not a motion sensor (ENODEV).
+ */
+static inline bool GyroSpaceEvdev_OpenDevice(GyroSpaceEvdevDevice* dev, const char* path, GyroSpaceContext* ctx,
+                                             GyroSpaceSampleCallback onSample, void* userData) {
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct input_absinfo gyroInfo, accelInfo;
+    if (!GyroSpaceEvdev_IsMotionSensor(fd) ||
+        ioctl(fd, EVIOCGABS(ABS_RX), &gyroInfo) < 0 ||
+        ioctl(fd, EVIOCGABS(ABS_X), &accelInfo) < 0) {
+        close(fd);
+        errno = ENODEV;
+        return false;
+    }
+
+    GyroSpaceEvdev_InitDevice(dev, ctx, gyroInfo.resolution, accelInfo.resolution, onSample, userData);
+    dev->fd = fd;
+    return true;
+}
+
+/** Closes the device node. */
+static inline void GyroSpaceEvdev_CloseDevice(GyroSpaceEvdevDevice* dev) {
+    if (dev->fd >= 0)
+        close(dev->fd);
+    dev->fd = -1;
+}
+
+/**
+ * Drains everything currently queued on the device, GYROSPACE_EVDEV_READ_BATCH
+ * events per read(). Returns the number of samples emitted, or -1 on a read
+ * error other than EAGAIN (ENODEV means the controller was unplugged).
+ */
+static inline int GyroSpaceEvdev_ReadDevice(GyroSpaceEvdevDevice* dev) {
+    struct input_event events[GYROSPACE_EVDEV_READ_BATCH];
+    int samples = 0;
+
+    for (;;) {
+        ssize_t bytes = read(dev->fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EINTR)
+                continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? samples : -1;
+        }
+        if (bytes == 0)
+            return samples;
+
+        samples += (int)GyroSpaceEvdev_FeedEvents(dev, events, (size_t)bytes / sizeof(struct input_event));
+        if ((size_t)bytes < sizeof(events))
+            return samples;
+    }
+}
+
+// epoll Backend
+
+/** Creates the epoll set. Returns false with errno set on failure. */
+static inline bool GyroSpaceEvdev_InitBackend(GyroSpaceEvdevBackend* backend) {
+    backend->deviceCount = 0;
+    backend->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    return backend->epollFd >= 0;
+}
+
+/** Adds an opened device to the backend. The device must outlive its registration. */
+static inline bool GyroSpaceEvdev_AddDevice(GyroSpaceEvdevBackend* backend, GyroSpaceEvdevDevice* dev) {
+    if (backend->deviceCount >= GYROSPACE_EVDEV_MAX_DEVICES) {
+        errno = ENOSPC;
+        return false;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = dev;
+    if (epoll_ctl(backend->epollFd, EPOLL_CTL_ADD, dev->fd, &ev) < 0)
+        return false;
+
+    backend->devices[backend->deviceCount++] = dev;
+    return true;
+}
+
+/** Removes a device from the backend (e.g. on unplug). Does not close it. */
+static inline void GyroSpaceEvdev_RemoveDevice(GyroSpaceEvdevBackend* backend, GyroSpaceEvdevDevice* dev) {
+    epoll_ctl(backend->epollFd, EPOLL_CTL_DEL, dev->fd, NULL);
+    for (size_t i = 0; i < backend->deviceCount; ++i) {
+        if (backend->devices[i] == dev) {
+            backend->devices[i] = backend->devices[--backend->deviceCount];
+            break;
+        }
+    }
+}
+
+/**
+ * Waits up to timeoutMs (-1 = forever) for input, then drains every ready
+ * device. Devices that fail with a read error or hang up are removed from
+ * the set. Returns the number of samples emitted, or -1 if epoll_wait failed.
+ */
+static inline int GyroSpaceEvdev_Poll(GyroSpaceEvdevBackend* backend, int timeoutMs) {
+    struct epoll_event ready[GYROSPACE_EVDEV_MAX_DEVICES];
+    int n = epoll_wait(backend->epollFd, ready, GYROSPACE_EVDEV_MAX_DEVICES, timeoutMs);
+    if (n < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    int samples = 0;
+    for (int i = 0; i < n; ++i) {
+        GyroSpaceEvdevDevice* dev = (GyroSpaceEvdevDevice*)ready[i].data.ptr;
+        int result = (ready[i].events & EPOLLIN) ? GyroSpaceEvdev_ReadDevice(dev) : -1;
+        if (result < 0 || (ready[i].events & (EPOLLHUP | EPOLLERR)))
+            GyroSpaceEvdev_RemoveDevice(backend, dev);
+        if (result > 0)
+            samples += result;
+    }
+    return samples;
+}
+
+/** Closes the epoll set. Devices stay open. */
+static inline void GyroSpaceEvdev_ShutdownBackend(GyroSpaceEvdevBackend* backend) {
+    if (backend->epollFd >= 0)
+        close(backend->epollFd);
+    backend->epollFd = -1;
+    backend->deviceCount = 0;
+}
+
+// uinput Mouse Sink
+
+/**
+ * Virtual mouse fed from transformed gyro output.
+ *
+ * Motion is accumulated in float; only whole counts are sent and the
+ * fractional remainder of each axis is carried into the next frame, so slow
+ * aiming is not lost to integer truncation. Each flush writes REL_X, REL_Y
+ * and SYN_REPORT with a single write().
+ */
+typedef struct {
+    int fd;
+    float accumX;         // Pending motion including the carried remainder
+    float accumY;
+} GyroSpaceMouseSink;
+
+/**
+ * Creates a uinput mouse named name. Needs write access to /dev/uinput.
+ * Returns false with errno set on failure.
+ */
+static inline bool GyroSpaceMouse_Open(GyroSpaceMouseSink* sink, const char* name) {
+    sink->fd = -1;
+    sink->accumX = 0.0f;
+    sink->accumY = 0.0f;
+
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    // A button is required for desktop stacks to treat the device as a mouse
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x4753;   // "GS"
+    setup.id.product = 0x0001;
+    strncpy(setup.name, name, UINPUT_MAX_NAME_SIZE - 1);
+
+    if (ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0 || ioctl(fd, UI_SET_KEYBIT, BTN_LEFT) < 0 ||
+        ioctl(fd, UI_SET_EVBIT, EV_REL) < 0 || ioctl(fd, UI_SET_RELBIT, REL_X) < 0 ||
+        ioctl(fd, UI_SET_RELBIT, REL_Y) < 0 ||
+        ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return false;
+    }
+
+    sink->fd = fd;
+    return true;
+}
+
+/**
+ * Writes the kernel's name for the device (e.g. "input23") into buffer, so
+ * the matching /sys/devices/virtual/input/<name>/event* node can be opened
+ * to read the events back.
+ */
+static inline bool GyroSpaceMouse_GetSysName(const GyroSpaceMouseSink* sink, char* buffer, size_t size) {
+    return ioctl(sink->fd, UI_GET_SYSNAME(size), buffer) >= 0;
+}
+
+/** Queues motion in counts (pixels); sent on the next flush. */
+static inline void GyroSpaceMouse_Move(GyroSpaceMouseSink* sink, float dx, float dy) {
+    sink->accumX += dx;
+    sink->accumY += dy;
+}
+
+/**
+ * Queues yaw and pitch rates (degrees per second) over deltaTime seconds:
+ * yaw moves x and pitch moves y, scaled by countsPerDegree.
+ */
+static inline void GyroSpaceMouse_MoveYawPitch(GyroSpaceMouseSink* sink, float yaw, float pitch,
+                                               float deltaTime, float countsPerDegree) {
+    float scale = deltaTime * countsPerDegree;
+    GyroSpaceMouse_Move(sink, yaw * scale, pitch * scale);
+}
+
+/**
+ * Queues motion from a transform output (degrees per second) in the given
+ * space. Local and Player Space put yaw first; World Space outputs
+ * (pitch, yaw, roll), so its first two components are swapped here.
+ */
+static inline void GyroSpaceMouse_MoveFromGyro(GyroSpaceMouseSink* sink, GyroSpaceTransformSpace space, Vector3 gyro,
+                                               float deltaTime, float countsPerDegree) {
+    if (space == GYROSPACE_SPACE_WORLD)
+        GyroSpaceMouse_MoveYawPitch(sink, gyro.y, gyro.x, deltaTime, countsPerDegree);
+    else
+        GyroSpaceMouse_MoveYawPitch(sink, gyro.x, gyro.y, deltaTime, countsPerDegree);
+}
+
+/**
+ * Sends the whole counts queued since the last flush as one report,
+ * carrying the fractional remainders. Does nothing if there is no whole
+ * count to send. Returns false with errno set if the write failed; the
+ * motion stays queued in that case.
+ */
+static inline bool GyroSpaceMouse_Flush(GyroSpaceMouseSink* sink) {
+    float wholeX = truncf(sink->accumX);
+    float wholeY = truncf(sink->accumY);
+    if (wholeX == 0.0f && wholeY == 0.0f)
+        return true;
+
+    struct input_event events[3];
+    size_t count = 0;
+    memset(events, 0, sizeof(events));
+    if (wholeX != 0.0f) {
+        events[count].type = EV_REL;
+        events[count].code = REL_X;
+        events[count].value = (int32_t)wholeX;
+        count++;
+    }
+    if (wholeY != 0.0f) {
+        events[count].type = EV_REL;
+        events[count].code = REL_Y;
+        events[count].value = (int32_t)wholeY;
+        count++;
+    }
+    events[count].type = EV_SYN;
+    events[count].code = SYN_REPORT;
+    count++;
+
+    ssize_t bytes = write(sink->fd, events, count * sizeof(struct input_event));
+    if (bytes != (ssize_t)(count * sizeof(struct input_event)))
+        return false;
+
+    sink->accumX -= wholeX;
+    sink->accumY -= wholeY;
+    return true;
+}
+
+/** Destroys the virtual device. */
+static inline void GyroSpaceMouse_Close(GyroSpaceMouseSink* sink) {
+    if (sink->fd >= 0) {
+        ioctl(sink->fd, UI_DEV_DESTROY);
+        close(sink->fd);
+    }
+    sink->fd = -1;
+}
+
+// Huge-Page Context Pool
+
+#define GYROSPACE_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+
+/** Release callback for GyroSpaceMem_CreateContextPool. */
+static inline void GyroSpaceMem_ReleaseMapping(void* allocation, size_t size) {
+    munmap(allocation, size);
+}
+
+/**
+ * Creates a context pool in an anonymous mapping rounded up to 2 MiB.
+ * Explicit huge pages (MAP_HUGETLB) are tried first; if none are reserved,
+ * falls back to regular pages with a transparent huge page hint. Returns
+ * false and sets errno if the mapping fails.
+ */
+static inline bool GyroSpaceMem_CreateContextPool(GyroSpaceContextPool* pool, uint32_t capacity) {
+    size_t size = GyroSpace_ContextPoolBytes(capacity);
+    size_t mapped = (size + GYROSPACE_HUGE_PAGE_SIZE - 1) & ~(size_t)(GYROSPACE_HUGE_PAGE_SIZE - 1);
+
+    void* block = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (block == MAP_FAILED) {
+        block = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) {
+            int savedErrno = errno;
+            GyroSpace_InitContextPool(pool, NULL, 0, 0);
+            errno = savedErrno;
+            return false;
+        }
+        madvise(block, mapped, MADV_HUGEPAGE);
+    }
+
+    if (!GyroSpace_InitContextPool(pool, block, mapped, capacity)) {
+        munmap(block, mapped);
+        errno = EINVAL;
+        return false;
+    }
+
+    pool->allocation = block;
+    pool->allocationSize = mapped;
+    pool->release = GyroSpaceMem_ReleaseMapping;
+    return true;
+}
+
+// Shared-Memory Output Channel
+
+/** Reader slots in a shared channel. */
+#ifndef GYROSPACE_SHM_MAX_READERS
+    #define GYROSPACE_SHM_MAX_READERS 8
+#endif
+
+#define GYROSPACE_SHM_MAGIC 0x47534852u // "GSHR"
+#define GYROSPACE_SHM_VERSION 2
+
+/** One published output sample. */
+typedef struct {
+    uint64_t timestamp;   // Caller units (e.g. microseconds)
+    Vector3 output;       // TransformTo*Space result
+    uint32_t deviceId;
+} GyroSpaceSharedSample;
+
+/** Per-reader state in shared memory, one cache line each. */
+typedef struct GYROSPACE_ALIGN(64) {
+    uint64_t cursor;      // Next sample index the reader will consume
+    uint32_t active;      // Slot claimed
+    uint32_t waiting;     // Reader is blocked on its eventfd
+} GyroSpaceSharedReaderSlot;
+
+/**
+ * Shared-memory layout: header, reader slots, then the sample ring.
+ * head counts every sample ever published; sample i lives at i & mask.
+ * reserve is moved past the samples being written before the ring is
+ * touched, so a reader that finds reserve within capacity of its cursor
+ * after copying knows no slot it read was being overwritten (a seqlock
+ * over the whole ring).
+ */
+typedef struct GYROSPACE_ALIGN(64) {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;    // Power of two
+    uint32_t mask;
+    uint64_t head;        // Samples fully written
+    uint64_t reserve;     // Samples written or being written (>= head)
+    GyroSpaceSharedReaderSlot readers[GYROSPACE_SHM_MAX_READERS];
+} GyroSpaceSharedHeader;
+
+/**
+ * Single-writer, many-reader ring of output samples.
+ *
+ * The writer never waits for readers: a reader that falls more than
+ * capacity samples behind loses the oldest ones and is told how many.
+ * Readers look at samples in place and only copy what they keep. Each
+ * reader slot has its own eventfd; the writer only signals readers that
+ * have marked themselves as waiting, so a busy consumer costs no syscalls.
+ */
+typedef struct {
+    int shmFd;
+    size_t mappedSize;
+    GyroSpaceSharedHeader* header;
+    GyroSpaceSharedSample* samples;
+    int eventFds[GYROSPACE_SHM_MAX_READERS];   // Writer: one per slot
+} GyroSpaceSharedWriter;
+
+/** A consumer attached to one reader slot. */
+typedef struct {
+    int shmFd;
+    int eventFd;          // -1 if the reader only polls
+    size_t mappedSize;
+    uint32_t slot;
+    GyroSpaceSharedHeader* header;
+    const GyroSpaceSharedSample* samples;
+} GyroSpaceSharedReader;
+
+/** Bytes needed for a channel of capacity samples. */
+static inline size_t GyroSpaceShm_MappedSize(uint32_t capacity) {
+    return sizeof(GyroSpaceSharedHeader) + (size_t)capacity * sizeof(GyroSpaceSharedSample);
+}
+
+/** Unmaps and closes the channel. Named channels are also unlinked if name is given. */
+static inline void GyroSpaceShm_DestroyWriter(GyroSpaceSharedWriter* w, const char* name) {
+    if (w->header)
+        munmap(w->header, w->mappedSize);
+    if (w->shmFd >= 0)
+        close(w->shmFd);
+    for (int i = 0; i < GYROSPACE_SHM_MAX_READERS; ++i)
+        if (w->eventFds[i] >= 0)
+            close(w->eventFds[i]);
+    if (name)
+        shm_unlink(name);
+    w->header = NULL;
+    w->shmFd = -1;
+}
+
+/**
+ * Creates the channel. With a name it is created through shm_open (e.g.
+ * "/gyrospace"); with NULL it is an anonymous memfd whose fd is handed to
+ * readers with GyroSpaceShm_SendFds. capacity is rounded up to a power of
+ * two. Returns false with errno set on failure.
+ */
+static inline bool GyroSpaceShm_CreateWriter(GyroSpaceSharedWriter* w, const char* name, uint32_t capacity) {
+    uint32_t cap = 16;
+    while (cap < capacity && cap < (1u << 30))
+        cap <<= 1;
+
+    w->header = NULL;
+    w->samples = NULL;
+    w->mappedSize = 0;
+    for (int i = 0; i < GYROSPACE_SHM_MAX_READERS; ++i)
+        w->eventFds[i] = -1;
+
+    w->shmFd = name ? shm_open(name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)
+                    : (int)syscall(SYS_memfd_create, "gyrospace", MFD_CLOEXEC);
+    if (w->shmFd < 0)
+        return false;
+
+    w->mappedSize = GyroSpaceShm_MappedSize(cap);
+    void* mem = MAP_FAILED;
+    if (ftruncate(w->shmFd, (off_t)w->mappedSize) == 0)
+        mem = mmap(NULL, w->mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, w->shmFd, 0);
+    if (mem == MAP_FAILED) {
+        int err = errno;
+        close(w->shmFd);
+        errno = err;
+        return false;
+    }
+
+    w->header = (GyroSpaceSharedHeader*)mem;
+    w->samples = (GyroSpaceSharedSample*)(w->header + 1);
+    memset(w->header, 0, sizeof(*w->header));
+    w->header->capacity = cap;
+    w->header->mask = cap - 1;
+
+    for (int i = 0; i < GYROSPACE_SHM_MAX_READERS; ++i) {
+        w->eventFds[i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (w->eventFds[i] < 0) {
+            int err = errno;
+            GyroSpaceShm_DestroyWriter(w, name);
+            errno = err;
+            return false;
+        }
+    }
+
+    // Publish the header last so readers never see a half-initialized channel
+    w->header->version = GYROSPACE_SHM_VERSION;
+    __atomic_store_n(&w->header->magic, GYROSPACE_SHM_MAGIC, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * Claims a free reader slot for a new consumer. Returns the slot index, or
+ * -1 if all slots are in use. The consumer then needs w->shmFd and
+ * w->eventFds[slot] (see GyroSpaceShm_SendFds).
+ */
+static inline int GyroSpaceShm_ClaimReaderSlot(GyroSpaceSharedWriter* w) {
+    for (int i = 0; i < GYROSPACE_SHM_MAX_READERS; ++i) {
+        uint32_t expected = 0;
+        GyroSpaceSharedReaderSlot* slot = &w->header->readers[i];
+        if (__atomic_compare_exchange_n(&slot->active, &expected, 1u, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&slot->cursor, __atomic_load_n(&w->header->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Publishes count samples and wakes waiting readers. The ring index is
+ * advanced once per call, so batching a frame's samples into one call keeps
+ * the handoff to a single release store.
+ */
+static inline void GyroSpaceShm_Publish(GyroSpaceSharedWriter* w, const GyroSpaceSharedSample* samples, size_t count) {
+    GyroSpaceSharedHeader* h = w->header;
+    uint64_t head = h->head;
+
+    // Claim the slots before overwriting them, so readers can detect torn samples
+    __atomic_store_n(&h->reserve, head + count, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (size_t i = 0; i < count; ++i)
+        w->samples[(head + i) & h->mask] = samples[i];
+    __atomic_store_n(&h->head, head + count, __ATOMIC_SEQ_CST);
+
+    for (int i = 0; i < GYROSPACE_SHM_MAX_READERS; ++i) {
+        GyroSpaceSharedReaderSlot* slot = &h->readers[i];
+        if (__atomic_load_n(&slot->waiting, __ATOMIC_SEQ_CST) &&
+            __atomic_exchange_n(&slot->waiting, 0u, __ATOMIC_SEQ_CST)) {
+            uint64_t one = 1;
+            ssize_t written = write(w->eventFds[i], &one, sizeof(one));
+            (void)written;
+        }
+    }
+}
+
+/** Releases a reader slot on the writer side (e.g. after the consumer disconnected). */
+static inline void GyroSpaceShm_ReleaseReaderSlot(GyroSpaceSharedWriter* w, int slot) {
+    __atomic_store_n(&w->header->readers[slot].active, 0u, __ATOMIC_RELEASE);
+}
+
+/**
+ * Attaches a reader to a slot claimed by the writer. shmFd is the channel
+ * fd (or an fd from shm_open on its name) and eventFd the slot's eventfd,
+ * or -1 to only poll. Takes ownership of both fds, also on failure, when
+ * both are closed. Returns false with errno set on failure.
+ */
+static inline bool GyroSpaceShm_AttachReader(GyroSpaceSharedReader* r, int shmFd, int eventFd, uint32_t slot) {
+    r->shmFd = shmFd;
+    r->eventFd = eventFd;
+    r->slot = slot;
+    r->header = NULL;
+    r->samples = NULL;
+    r->mappedSize = 0;
+
+    struct stat st;
+    int err = EINVAL;
+    if (slot < GYROSPACE_SHM_MAX_READERS && shmFd >= 0 && fstat(shmFd, &st) == 0 &&
+        (size_t)st.st_size >= sizeof(GyroSpaceSharedHeader)) {
+        // Readers map read-write only to update their own slot
+        void* mem = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+        if (mem == MAP_FAILED) {
+            err = errno;
+        } else {
+            GyroSpaceSharedHeader* h = (GyroSpaceSharedHeader*)mem;
+            if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) == GYROSPACE_SHM_MAGIC && h->version == GYROSPACE_SHM_VERSION &&
+                (size_t)st.st_size >= GyroSpaceShm_MappedSize(h->capacity)) {
+                r->mappedSize = (size_t)st.st_size;
+                r->header = h;
+                r->samples = (const GyroSpaceSharedSample*)(h + 1);
+                return true;
+            }
+            munmap(mem, (size_t)st.st_size);
+        }
+    }
+
+    if (shmFd >= 0)
+        close(shmFd);
+    if (eventFd >= 0)
+        close(eventFd);
+    r->shmFd = r->eventFd = -1;
+    errno = err;
+    return false;
+}
+
+/**
+ * Returns up to maxCount unread samples in place, without copying. *dropped
+ * receives how many samples were overwritten before this reader got to
+ * them. The span is contiguous, so it may hold fewer samples than are
+ * available when the ring wraps. Call GyroSpaceShm_Consume when done.
+ */
+static inline const GyroSpaceSharedSample* GyroSpaceShm_Peek(GyroSpaceSharedReader* r, size_t maxCount, size_t* count, uint64_t* dropped) {
+    GyroSpaceSharedHeader* h = r->header;
+    GyroSpaceSharedReaderSlot* slot = &h->readers[r->slot];
+    uint64_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+    uint64_t reserve = __atomic_load_n(&h->reserve, __ATOMIC_ACQUIRE);
+    uint64_t cursor = slot->cursor;
+
+    // Skip samples that are overwritten or about to be
+    *dropped = 0;
+    if (reserve - cursor > h->capacity) {
+        *dropped = reserve - cursor - h->capacity;
+        cursor = reserve - h->capacity;
+        slot->cursor = cursor;
+    }
+
+    uint64_t available = head > cursor ? head - cursor : 0;
+    uint64_t untilWrap = h->capacity - (cursor & h->mask);
+    if (available > untilWrap) available = untilWrap;
+    if (available > maxCount) available = maxCount;
+
+    *count = (size_t)available;
+    return r->samples + (cursor & h->mask);
+}
+
+/**
+ * Marks count peeked samples as consumed. Returns false if the writer
+ * started overwriting any of them before they were read, in which case
+ * the values seen must be discarded. Call only after the samples have
+ * been copied or used.
+ */
+static inline bool GyroSpaceShm_Consume(GyroSpaceSharedReader* r, size_t count) {
+    GyroSpaceSharedHeader* h = r->header;
+    GyroSpaceSharedReaderSlot* slot = &h->readers[r->slot];
+    uint64_t cursor = slot->cursor;
+
+    // Order the sample reads before the re-check of the writer's reservation
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t reserve = __atomic_load_n(&h->reserve, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->cursor, cursor + count, __ATOMIC_RELEASE);
+    return reserve - cursor <= h->capacity;
+}
+
+/**
+ * Copies up to maxCount unread samples into out. Returns the number copied;
+ * *dropped receives how many were lost to the writer, including any that
+ * were overwritten while being copied.
+ */
+static inline size_t GyroSpaceShm_Read(GyroSpaceSharedReader* r, GyroSpaceSharedSample* out, size_t maxCount, uint64_t* dropped) {
+    size_t total = 0;
+    *dropped = 0;
+
+    while (total < maxCount) {
+        size_t count;
+        uint64_t lost;
+        const GyroSpaceSharedSample* span = GyroSpaceShm_Peek(r, maxCount - total, &count, &lost);
+        *dropped += lost;
+        if (count == 0)
+            break;
+
+        memcpy(out + total, span, count * sizeof(*span));
+        if (GyroSpaceShm_Consume(r, count))
+            total += count;
+        else
+            *dropped += count;
+    }
+    return total;
+}
+
+/**
+ * Blocks until unread samples are available or timeoutMs elapses (-1 waits
+ * forever). Returns true if samples are available. Without an eventfd this
+ * only checks once.
+ */
+static inline bool GyroSpaceShm_Wait(GyroSpaceSharedReader* r, int timeoutMs) {
+    GyroSpaceSharedHeader* h = r->header;
+    GyroSpaceSharedReaderSlot* slot = &h->readers[r->slot];
+
+    if (__atomic_load_n(&h->head, __ATOMIC_ACQUIRE) != slot->cursor)
+        return true;
+    if (r->eventFd < 0)
+        return false;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (;;) {
+        // Announce the wait, then re-check so a publish in between is not missed
+        __atomic_store_n(&slot->waiting, 1u, __ATOMIC_SEQ_CST);
+        int ready = 0;
+        if (__atomic_load_n(&h->head, __ATOMIC_SEQ_CST) == slot->cursor) {
+            struct pollfd pfd;
+            pfd.fd = r->eventFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            ready = poll(&pfd, 1, timeoutMs);
+        }
+        __atomic_store_n(&slot->waiting, 0u, __ATOMIC_SEQ_CST);
+
+        uint64_t counter;
+        ssize_t bytes = read(r->eventFd, &counter, sizeof(counter));
+        (void)bytes;
+
+        if (__atomic_load_n(&h->head, __ATOMIC_ACQUIRE) != slot->cursor)
+            return true;
+        if (ready <= 0)
+            return false;
+
+        // Woken by a signal left over from an earlier wait: keep waiting out the timeout
+        if (timeoutMs >= 0) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            long elapsedMs = (long)(now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+            if (elapsedMs >= timeoutMs)
+                return false;
+            timeoutMs -= (int)elapsedMs;
+            start = now;
+        }
+    }
+}
+
+/** Releases the slot and unmaps the channel. */
+static inline void GyroSpaceShm_DetachReader(GyroSpaceSharedReader* r) {
+    if (r->header) {
+        __atomic_store_n(&r->header->readers[r->slot].active, 0u, __ATOMIC_RELEASE);
+        munmap(r->header, r->mappedSize);
+    }
+    if (r->shmFd >= 0)
+        close(r->shmFd);
+    if (r->eventFd >= 0)
+        close(r->eventFd);
+    r->header = NULL;
+    r->shmFd = r->eventFd = -1;
+}
+
+/**
+ * Sends the channel fd, a slot's eventfd and the slot index over a
+ * connected Unix socket (SCM_RIGHTS), for handing a slot to a consumer.
+ */
+static inline bool GyroSpaceShm_SendFds(int socketFd, int shmFd, int eventFd, uint32_t slot) {
+    int fds[2] = { shmFd, eventFd };
+    union {
+        char buffer[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov;
+    iov.iov_base = &slot;
+    iov.iov_len = sizeof(slot);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    return sendmsg(socketFd, &msg, MSG_NOSIGNAL) == (ssize_t)sizeof(slot);
+}
+
+/** Receives what GyroSpaceShm_SendFds sent and attaches r to it. */
+static inline bool GyroSpaceShm_AttachReaderFromSocket(GyroSpaceSharedReader* r, int socketFd) {
+    int fds[2] = { -1, -1 };
+    uint32_t slot = 0;
+    union {
+        char buffer[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } control;
+
+    struct iovec iov;
+    iov.iov_base = &slot;
+    iov.iov_len = sizeof(slot);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    if (recvmsg(socketFd, &msg, MSG_CMSG_CLOEXEC) != (ssize_t)sizeof(slot))
+        return false;
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(fds))) {
+        errno = EPROTO;
+        return false;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+
+    // AttachReader closes both fds if it fails
+    return GyroSpaceShm_AttachReader(r, fds[0], fds[1], slot);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // GYROSPACE_LINUX_HPP
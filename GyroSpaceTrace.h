@@ -0,0 +1,536 @@
+/*
+ * =======================================================================
+ *
+ * Gyro Space to Play - Compressed Motion Trace Format
+ *
+ * Optional companion to GyroSpace.h for recording long play sessions.
+ * Samples are quantized to the sensor's LSB, delta-coded against the
+ * previous sample, zigzag-mapped and varint-packed. A steady controller
+ * at full rate typically costs 7-10 bytes per sample instead of the
+ * 28 bytes of a raw float trace.
+ *
+ * Stream layout (all integers little-endian):
+ *
+ *   Stream header (16 bytes)
+ *     char[4]  magic "GSTR"
+ *     uint16   version (1)
+ *     uint16   reserved (0)
+ *     float32  gyro LSB (units per count)
+ *     float32  accel LSB (units per count)
+ *
+ *   Blocks, repeated
+ *     uint32   payload size in bytes
+ *     uint32   sample count
+ *     uint64   timestamp of the first sample
+ *     payload  per sample: 7 varints (timestamp delta-of-delta, gyro xyz
+ *              deltas, accel xyz deltas)
+ *
+ * The predictor resets at every block, so each block decodes on its own
+ * and the stream can be seeked by walking the fixed-size block headers.
+ *
+ * Compatible with both C and C++ environments.
+ *
+ * =======================================================================
+ */
+
+#ifndef GYROSPACE_TRACE_HPP
+#define GYROSPACE_TRACE_HPP
+
+#include "GyroSpace.h"
+
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GYROSPACE_TRACE_VERSION 1
+#define GYROSPACE_TRACE_HEADER_SIZE 16
+#define GYROSPACE_TRACE_BLOCK_HEADER_SIZE 16
+#define GYROSPACE_TRACE_CHANNELS 7
+#define GYROSPACE_TRACE_MAX_SAMPLE_BYTES (GYROSPACE_TRACE_CHANNELS * 5)
+
+// Type Definitions
+
+/** Destination columns for decoded samples (SoA, matching the batch transform API). */
+typedef struct {
+    uint64_t* timestamp;
+    float* gyroX;
+    float* gyroY;
+    float* gyroZ;
+    float* accelX;
+    float* accelY;
+    float* accelZ;
+} GyroSpaceTraceColumns;
+
+/** Location of one block inside a trace, as returned by GyroSpaceTrace_BuildIndex. */
+typedef struct {
+    size_t offset;           // Byte offset of the block header
+    uint32_t sampleCount;
+    uint32_t segment;        // Number of clock rewinds before this block
+    uint64_t firstTimestamp;
+} GyroSpaceTraceBlockInfo;
+
+/** Encoder state. Writes into a caller-provided buffer; never allocates. */
+typedef struct {
+    uint8_t* buffer;
+    size_t capacity;
+    size_t size;
+
+    float gyroInvLSB;
+    float accelInvLSB;
+    uint32_t samplesPerBlock;
+
+    size_t blockOffset;      // Header offset of the open block
+    uint32_t blockSamples;   // Samples written to the open block (0 = no open block)
+    uint64_t prevTimestamp;
+    uint32_t prevDelta;
+    uint32_t prev[6];
+} GyroSpaceTraceEncoder;
+
+/** Streaming decoder state. */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;           // Offset of the next block header
+
+    float gyroLSB;
+    float accelLSB;
+
+    const uint8_t* cursor;   // Read position inside the current block
+    const uint8_t* blockEnd;
+    uint32_t blockRemaining;
+    uint64_t prevTimestamp;
+    uint32_t prevDelta;
+    uint32_t prev[6];
+} GyroSpaceTraceDecoder;
+
+// Byte Helpers
+
+static inline void GyroSpaceTrace_Write32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void GyroSpaceTrace_Write64(uint8_t* p, uint64_t v) {
+    GyroSpaceTrace_Write32(p, (uint32_t)v);
+    GyroSpaceTrace_Write32(p + 4, (uint32_t)(v >> 32));
+}
+
+static inline uint32_t GyroSpaceTrace_Read32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t GyroSpaceTrace_Read64(const uint8_t* p) {
+    return (uint64_t)GyroSpaceTrace_Read32(p) | ((uint64_t)GyroSpaceTrace_Read32(p + 4) << 32);
+}
+
+/** Byte-swaps a natively loaded word to little-endian order on big-endian targets. */
+static inline uint64_t GyroSpaceTrace_ToLittleEndian64(uint64_t v) {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap64(v);
+#else
+    return v;
+#endif
+}
+
+/** Maps a signed delta to unsigned so small magnitudes of either sign stay small. */
+static inline uint32_t GyroSpaceTrace_ZigZag(uint32_t delta) {
+    return (delta << 1) ^ (uint32_t)-(int32_t)(delta >> 31);
+}
+
+/** Inverse of GyroSpaceTrace_ZigZag. */
+static inline uint32_t GyroSpaceTrace_UnZigZag(uint32_t v) {
+    return (v >> 1) ^ (uint32_t)-(int32_t)(v & 1);
+}
+
+/** Writes v as a LEB128 varint (1-5 bytes) and returns the new write position. */
+static inline uint8_t* GyroSpaceTrace_WriteVarint(uint8_t* p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+/** Reads a LEB128 varint. Returns false on truncated or overlong input. */
+static inline bool GyroSpaceTrace_ReadVarint(const uint8_t** p, const uint8_t* end, uint32_t* out) {
+    const uint8_t* q = *p;
+
+    // Fast path: most deltas of a held controller fit in one byte
+    if (q < end && *q < 0x80) {
+        *out = *q;
+        *p = q + 1;
+        return true;
+    }
+
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (q >= end)
+            return false;
+        uint32_t b = *q++;
+        result |= (b & 0x7F) << shift;
+        if (b < 0x80) {
+            *out = result;
+            *p = q;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Reads a varint without bounds checks. Only used when at least
+ * GYROSPACE_TRACE_MAX_SAMPLE_BYTES remain in the block.
+ */
+static inline uint32_t GyroSpaceTrace_ReadVarintUnchecked(const uint8_t** p) {
+    const uint8_t* q = *p;
+    uint32_t b = *q++;
+    uint32_t result = b;
+    if (b >= 0x80) {
+        result &= 0x7F;
+        int shift = 7;
+        do {
+            b = *q++;
+            result |= (b & 0x7F) << shift;
+            shift += 7;
+        } while (b >= 0x80 && shift < 35);
+    }
+    *p = q;
+    return result;
+}
+
+/** Quantizes a value to sensor counts. */
+static inline uint32_t GyroSpaceTrace_Quantize(float value, float invLSB) {
+    float q = clamp(value * invLSB, -2147483520.0f, 2147483520.0f);
+    return (uint32_t)(int32_t)lrintf(q);
+}
+
+// Encoder
+
+/**
+ * Initializes an encoder over buffer and writes the stream header.
+ * gyroLSB/accelLSB are the sensor resolutions in the units the caller feeds
+ * (e.g. deg/s and g per count). Returns false if the buffer is too small or
+ * an argument is invalid.
+ */
+static inline bool GyroSpaceTrace_InitEncoder(GyroSpaceTraceEncoder* enc, uint8_t* buffer, size_t capacity,
+                                              float gyroLSB, float accelLSB, uint32_t samplesPerBlock) {
+    if (capacity < GYROSPACE_TRACE_HEADER_SIZE || !(gyroLSB > 0.0f) || !(accelLSB > 0.0f) || samplesPerBlock == 0)
+        return false;
+
+    memset(enc, 0, sizeof(*enc));
+    enc->buffer = buffer;
+    enc->capacity = capacity;
+    enc->gyroInvLSB = 1.0f / gyroLSB;
+    enc->accelInvLSB = 1.0f / accelLSB;
+    enc->samplesPerBlock = samplesPerBlock;
+
+    uint32_t gyroBits, accelBits;
+    memcpy(&gyroBits, &gyroLSB, sizeof(gyroBits));
+    memcpy(&accelBits, &accelLSB, sizeof(accelBits));
+
+    memcpy(buffer, "GSTR", 4);
+    buffer[4] = GYROSPACE_TRACE_VERSION; buffer[5] = 0;
+    buffer[6] = 0; buffer[7] = 0;
+    GyroSpaceTrace_Write32(buffer + 8, gyroBits);
+    GyroSpaceTrace_Write32(buffer + 12, accelBits);
+    enc->size = GYROSPACE_TRACE_HEADER_SIZE;
+    return true;
+}
+
+/** Patches the header of the open block, if any. */
+static inline void GyroSpaceTrace_CloseBlock(GyroSpaceTraceEncoder* enc) {
+    if (enc->blockSamples == 0)
+        return;
+
+    uint8_t* header = enc->buffer + enc->blockOffset;
+    GyroSpaceTrace_Write32(header, (uint32_t)(enc->size - enc->blockOffset - GYROSPACE_TRACE_BLOCK_HEADER_SIZE));
+    GyroSpaceTrace_Write32(header + 4, enc->blockSamples);
+    enc->blockSamples = 0;
+}
+
+/**
+ * Appends one sample. timestamp is in caller units (e.g. microseconds).
+ * A gap that does not fit the 32-bit delta, or a timestamp that goes
+ * backwards, starts a new block so the full 64-bit value is kept in its
+ * header; GyroSpaceTrace_BuildIndex reports a backwards jump as a new
+ * segment. Returns false, without writing anything, if the buffer cannot
+ * hold the sample.
+ */
+static inline bool GyroSpaceTrace_Append(GyroSpaceTraceEncoder* enc, uint64_t timestamp, Vector3 gyro, Vector3 accel) {
+    if (enc->blockSamples >= enc->samplesPerBlock ||
+        (enc->blockSamples > 0 && (timestamp < enc->prevTimestamp || timestamp - enc->prevTimestamp > UINT32_MAX)))
+        GyroSpaceTrace_CloseBlock(enc);
+
+    size_t needed = GYROSPACE_TRACE_MAX_SAMPLE_BYTES + (enc->blockSamples == 0 ? GYROSPACE_TRACE_BLOCK_HEADER_SIZE : 0);
+    if (enc->capacity - enc->size < needed)
+        return false;
+
+    if (enc->blockSamples == 0) {
+        // New block: reset the predictor so the block decodes independently
+        enc->blockOffset = enc->size;
+        GyroSpaceTrace_Write64(enc->buffer + enc->size + 8, timestamp);
+        enc->size += GYROSPACE_TRACE_BLOCK_HEADER_SIZE;
+        enc->prevTimestamp = timestamp;
+        enc->prevDelta = 0;
+        memset(enc->prev, 0, sizeof(enc->prev));
+    }
+
+    uint32_t q[6] = {
+        GyroSpaceTrace_Quantize(gyro.x, enc->gyroInvLSB),
+        GyroSpaceTrace_Quantize(gyro.y, enc->gyroInvLSB),
+        GyroSpaceTrace_Quantize(gyro.z, enc->gyroInvLSB),
+        GyroSpaceTrace_Quantize(accel.x, enc->accelInvLSB),
+        GyroSpaceTrace_Quantize(accel.y, enc->accelInvLSB),
+        GyroSpaceTrace_Quantize(accel.z, enc->accelInvLSB)
+    };
+
+    // Timestamps are delta-of-delta coded: a fixed sample rate costs one byte
+    uint32_t delta = (uint32_t)(timestamp - enc->prevTimestamp);
+    uint8_t* p = enc->buffer + enc->size;
+    p = GyroSpaceTrace_WriteVarint(p, GyroSpaceTrace_ZigZag(delta - enc->prevDelta));
+    for (int i = 0; i < 6; ++i) {
+        p = GyroSpaceTrace_WriteVarint(p, GyroSpaceTrace_ZigZag(q[i] - enc->prev[i]));
+        enc->prev[i] = q[i];
+    }
+
+    enc->prevTimestamp = timestamp;
+    enc->prevDelta = delta;
+    enc->size = (size_t)(p - enc->buffer);
+    enc->blockSamples++;
+    return true;
+}
+
+/** Closes the open block and returns the total number of bytes written. */
+static inline size_t GyroSpaceTrace_Finish(GyroSpaceTraceEncoder* enc) {
+    GyroSpaceTrace_CloseBlock(enc);
+    return enc->size;
+}
+
+// Decoder
+
+/** Initializes a decoder over a complete trace. Returns false if the stream header is invalid. */
+static inline bool GyroSpaceTrace_InitDecoder(GyroSpaceTraceDecoder* dec, const uint8_t* data, size_t size) {
+    if (size < GYROSPACE_TRACE_HEADER_SIZE || memcmp(data, "GSTR", 4) != 0 || data[4] != GYROSPACE_TRACE_VERSION)
+        return false;
+
+    memset(dec, 0, sizeof(*dec));
+    dec->data = data;
+    dec->size = size;
+    dec->offset = GYROSPACE_TRACE_HEADER_SIZE;
+
+    uint32_t gyroBits = GyroSpaceTrace_Read32(data + 8);
+    uint32_t accelBits = GyroSpaceTrace_Read32(data + 12);
+    memcpy(&dec->gyroLSB, &gyroBits, sizeof(gyroBits));
+    memcpy(&dec->accelLSB, &accelBits, sizeof(accelBits));
+    return true;
+}
+
+/**
+ * Positions the decoder at the block header found at offset (see
+ * GyroSpaceTrace_BuildIndex). An offset past the end of the trace seeks
+ * to the end, so the next decode returns 0.
+ */
+static inline void GyroSpaceTrace_Seek(GyroSpaceTraceDecoder* dec, size_t offset) {
+    dec->offset = offset < dec->size ? offset : dec->size;
+    dec->blockRemaining = 0;
+}
+
+/** Opens the block at dec->offset. Returns false at end of stream or on a truncated block. */
+static inline bool GyroSpaceTrace_OpenBlock(GyroSpaceTraceDecoder* dec) {
+    if (dec->offset > dec->size || dec->size - dec->offset < GYROSPACE_TRACE_BLOCK_HEADER_SIZE)
+        return false;
+
+    const uint8_t* header = dec->data + dec->offset;
+    uint32_t payload = GyroSpaceTrace_Read32(header);
+    uint32_t count = GyroSpaceTrace_Read32(header + 4);
+    if (dec->size - dec->offset - GYROSPACE_TRACE_BLOCK_HEADER_SIZE < payload)
+        return false;
+
+    dec->cursor = header + GYROSPACE_TRACE_BLOCK_HEADER_SIZE;
+    dec->blockEnd = dec->cursor + payload;
+    dec->blockRemaining = count;
+    dec->prevTimestamp = GyroSpaceTrace_Read64(header + 8);
+    dec->prevDelta = 0;
+    memset(dec->prev, 0, sizeof(dec->prev));
+    dec->offset += GYROSPACE_TRACE_BLOCK_HEADER_SIZE + payload;
+    return true;
+}
+
+/**
+ * Decodes up to maxSamples samples into out, continuing across blocks.
+ * Returns the number of samples written; 0 means end of stream (or a
+ * corrupt block, which stops decoding).
+ */
+static inline size_t GyroSpaceTrace_Decode(GyroSpaceTraceDecoder* dec, const GyroSpaceTraceColumns* out, size_t maxSamples) {
+    const float gyroLSB = dec->gyroLSB;
+    const float accelLSB = dec->accelLSB;
+    size_t written = 0;
+
+    while (written < maxSamples) {
+        if (dec->blockRemaining == 0 && !GyroSpaceTrace_OpenBlock(dec))
+            break;
+
+        const uint8_t* p = dec->cursor;
+        const uint8_t* end = dec->blockEnd;
+        uint64_t timestamp = dec->prevTimestamp;
+        uint32_t delta = dec->prevDelta;
+        uint32_t g0 = dec->prev[0], g1 = dec->prev[1], g2 = dec->prev[2];
+        uint32_t a0 = dec->prev[3], a1 = dec->prev[4], a2 = dec->prev[5];
+
+        size_t n = dec->blockRemaining;
+        if (n > maxSamples - written)
+            n = maxSamples - written;
+
+        size_t i = 0;
+        for (; i < n; ++i) {
+            uint32_t d0, d1, d2, d3, d4, d5, d6;
+            uint64_t word = 0x80;
+            if (end - p >= GYROSPACE_TRACE_MAX_SAMPLE_BYTES) {
+                memcpy(&word, p, sizeof(word));
+                word = GyroSpaceTrace_ToLittleEndian64(word);
+            }
+
+            if ((word & 0x0080808080808080ull) == 0) {
+                // Every channel fits in one byte, the common case for a held controller:
+                // un-zigzag all seven at once, leaving each byte as a signed delta
+                uint64_t bytes = ((word >> 1) & 0x003F3F3F3F3F3F3Full) ^ ((word & 0x0001010101010101ull) * 0xFF);
+                d0 = (uint32_t)(int32_t)(int8_t)bytes;
+                d1 = (uint32_t)(int32_t)(int8_t)(bytes >> 8);
+                d2 = (uint32_t)(int32_t)(int8_t)(bytes >> 16);
+                d3 = (uint32_t)(int32_t)(int8_t)(bytes >> 24);
+                d4 = (uint32_t)(int32_t)(int8_t)(bytes >> 32);
+                d5 = (uint32_t)(int32_t)(int8_t)(bytes >> 40);
+                d6 = (uint32_t)(int32_t)(int8_t)(bytes >> 48);
+                p += GYROSPACE_TRACE_CHANNELS;
+            } else {
+                uint32_t v[GYROSPACE_TRACE_CHANNELS];
+                if (end - p >= GYROSPACE_TRACE_MAX_SAMPLE_BYTES) {
+                    for (int c = 0; c < GYROSPACE_TRACE_CHANNELS; ++c)
+                        v[c] = GyroSpaceTrace_ReadVarintUnchecked(&p);
+                } else {
+                    // Tail of the block: bounds-check every byte
+                    bool ok = true;
+                    for (int c = 0; c < GYROSPACE_TRACE_CHANNELS && ok; ++c)
+                        ok = GyroSpaceTrace_ReadVarint(&p, end, &v[c]);
+                    if (!ok)
+                        break;
+                }
+                d0 = GyroSpaceTrace_UnZigZag(v[0]);
+                d1 = GyroSpaceTrace_UnZigZag(v[1]);
+                d2 = GyroSpaceTrace_UnZigZag(v[2]);
+                d3 = GyroSpaceTrace_UnZigZag(v[3]);
+                d4 = GyroSpaceTrace_UnZigZag(v[4]);
+                d5 = GyroSpaceTrace_UnZigZag(v[5]);
+                d6 = GyroSpaceTrace_UnZigZag(v[6]);
+            }
+
+            delta += d0;
+            timestamp += delta;
+            g0 += d1;
+            g1 += d2;
+            g2 += d3;
+            a0 += d4;
+            a1 += d5;
+            a2 += d6;
+
+            size_t o = written + i;
+            out->timestamp[o] = timestamp;
+            out->gyroX[o] = (float)(int32_t)g0 * gyroLSB;
+            out->gyroY[o] = (float)(int32_t)g1 * gyroLSB;
+            out->gyroZ[o] = (float)(int32_t)g2 * gyroLSB;
+            out->accelX[o] = (float)(int32_t)a0 * accelLSB;
+            out->accelY[o] = (float)(int32_t)a1 * accelLSB;
+            out->accelZ[o] = (float)(int32_t)a2 * accelLSB;
+        }
+
+        dec->cursor = p;
+        dec->prevTimestamp = timestamp;
+        dec->prevDelta = delta;
+        dec->prev[0] = g0; dec->prev[1] = g1; dec->prev[2] = g2;
+        dec->prev[3] = a0; dec->prev[4] = a1; dec->prev[5] = a2;
+        written += i;
+
+        if (i < n) {
+            // Corrupt payload: drop the rest of the stream
+            dec->blockRemaining = 0;
+            dec->offset = dec->size;
+            break;
+        }
+        dec->blockRemaining -= (uint32_t)n;
+    }
+
+    return written;
+}
+
+// Seeking
+
+/**
+ * Walks the block headers of a trace and fills index with up to maxBlocks
+ * entries. Only headers are read, so this is cheap even for long sessions.
+ * A block whose first timestamp is lower than the previous block's (the
+ * recording clock went backwards) starts a new segment; within a segment
+ * first timestamps never decrease. Returns the total number of blocks in
+ * the trace.
+ */
+static inline size_t GyroSpaceTrace_BuildIndex(const uint8_t* data, size_t size, GyroSpaceTraceBlockInfo* index, size_t maxBlocks) {
+    size_t blocks = 0;
+    size_t offset = GYROSPACE_TRACE_HEADER_SIZE;
+    uint32_t segment = 0;
+    uint64_t prevFirst = 0;
+
+    while (size >= offset && size - offset >= GYROSPACE_TRACE_BLOCK_HEADER_SIZE) {
+        uint32_t payload = GyroSpaceTrace_Read32(data + offset);
+        if (size - offset - GYROSPACE_TRACE_BLOCK_HEADER_SIZE < payload)
+            break;
+
+        uint64_t first = GyroSpaceTrace_Read64(data + offset + 8);
+        if (blocks > 0 && first < prevFirst)
+            segment++;
+        prevFirst = first;
+
+        if (blocks < maxBlocks) {
+            index[blocks].offset = offset;
+            index[blocks].sampleCount = GyroSpaceTrace_Read32(data + offset + 4);
+            index[blocks].segment = segment;
+            index[blocks].firstTimestamp = first;
+        }
+        blocks++;
+        offset += GYROSPACE_TRACE_BLOCK_HEADER_SIZE + payload;
+    }
+
+    return blocks;
+}
+
+/**
+ * Returns the index of the last block starting at or before timestamp (0 if
+ * none). This is a binary search, so the entries passed in must belong to
+ * one segment; for a trace with clock rewinds, search each segment's range
+ * (see GyroSpaceTrace_SegmentEnd) separately.
+ */
+static inline size_t GyroSpaceTrace_FindBlock(const GyroSpaceTraceBlockInfo* index, size_t blockCount, uint64_t timestamp) {
+    size_t lo = 0, hi = blockCount;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index[mid].firstTimestamp <= timestamp)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/** Returns one past the last entry of the segment that starts at index[first]. */
+static inline size_t GyroSpaceTrace_SegmentEnd(const GyroSpaceTraceBlockInfo* index, size_t blockCount, size_t first) {
+    size_t end = first;
+    while (end < blockCount && index[end].segment == index[first].segment)
+        end++;
+    return end;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GYROSPACE_TRACE_HPP
@@ -0,0 +1,163 @@
+/*
+ * Angle accumulation drift test and benchmark.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/angle_drift.c -lm -o angle_drift && ./angle_drift
+ *
+ * Integrates 10^8 samples (about 28 hours at 1000 Hz) through
+ * GyroSpace_AccumulateAngle and GyroSpace_AccumulateAngleBatch and checks
+ * that the total stays within a bound of a compensated reference sum,
+ * then reports nanoseconds per sample against a plain float sum.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define DRIFT_SAMPLES 100000000u
+#define DRIFT_DT 0.001f
+#define DRIFT_BOUND 1e-3      // Degrees after 10^8 samples
+#define BATCH 1000u
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static double Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/** Aiming-like yaw rate in deg/s: slow drift with periodic fast turns. */
+static float Rate(uint32_t i) {
+    uint32_t phase = i % 5000u;
+    return (phase < 300u) ? 240.0f + (float)(phase % 17u) : 37.3f - (float)(phase % 11u) * 0.5f;
+}
+
+/** Kahan-compensated sum of the same float steps: the reference total. */
+typedef struct {
+    double sum;
+    double carry;
+} Compensated;
+
+static void CompensatedAdd(Compensated* c, double value) {
+    double y = value - c->carry;
+    double t = c->sum + y;
+    c->carry = (t - c->sum) - y;
+    c->sum = t;
+}
+
+static void TestDrift(void) {
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    Compensated reference = { 0.0, 0.0 };
+    float floatSum = 0.0f;
+
+    for (uint32_t i = 0; i < DRIFT_SAMPLES; ++i) {
+        float rate = Rate(i);
+        GyroSpace_AccumulateAngle(&ctx, Vec3_New(rate, -rate, 0.0f), DRIFT_DT);
+        CompensatedAdd(&reference, (double)(rate * DRIFT_DT));
+        floatSum += rate * DRIFT_DT;
+    }
+
+    double error = fabs(ctx.angleX - reference.sum);
+    printf("per-sample: total %.6f deg, drift %.3g deg (float sum drift %.3g deg)\n",
+           reference.sum, error, fabs((double)floatSum - reference.sum));
+    CHECK(error < DRIFT_BOUND);
+    CHECK(ctx.angleY == -ctx.angleX);
+
+    Vector3 heading = GyroSpace_GetAccumulatedHeading(&ctx);
+    double expected = fmod(reference.sum + 180.0, 360.0) - 180.0;
+    CHECK(heading.x >= -180.0f && heading.x < 180.0f);
+    CHECK(fabs((double)heading.x - expected) < DRIFT_BOUND);
+}
+
+static void TestBatchDrift(void) {
+    static float x[BATCH], y[BATCH], z[BATCH];
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    Compensated reference = { 0.0, 0.0 };
+
+    for (uint32_t base = 0; base < DRIFT_SAMPLES; base += BATCH) {
+        for (uint32_t k = 0; k < BATCH; ++k) {
+            x[k] = Rate(base + k);
+            y[k] = 0.5f * x[k];
+            z[k] = 0.0f;
+            CompensatedAdd(&reference, (double)(x[k] * DRIFT_DT));
+        }
+        GyroSpace_AccumulateAngleBatch(&ctx, x, y, z, DRIFT_DT, BATCH);
+    }
+
+    double error = fabs(ctx.angleX - reference.sum);
+    printf("batch:      total %.6f deg, drift %.3g deg\n", reference.sum, error);
+    CHECK(error < DRIFT_BOUND);
+}
+
+static void Benchmark(void) {
+    static float x[BATCH], y[BATCH], z[BATCH];
+    for (uint32_t k = 0; k < BATCH; ++k) {
+        x[k] = Rate(k);
+        y[k] = -x[k];
+        z[k] = 0.25f * x[k];
+    }
+    const uint32_t rounds = DRIFT_SAMPLES / BATCH;
+
+    // Plain float sums: the cost the double accumulator is compared against
+    volatile float floatSink;
+    float fx = 0.0f, fy = 0.0f, fz = 0.0f;
+    double start = Seconds();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t k = 0; k < BATCH; ++k) {
+            fx += x[k] * DRIFT_DT;
+            fy += y[k] * DRIFT_DT;
+            fz += z[k] * DRIFT_DT;
+        }
+    }
+    double floatTime = Seconds() - start;
+    floatSink = fx + fy + fz;
+    (void)floatSink;
+
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    start = Seconds();
+    for (uint32_t r = 0; r < rounds; ++r)
+        for (uint32_t k = 0; k < BATCH; ++k)
+            GyroSpace_AccumulateAngle(&ctx, Vec3_New(x[k], y[k], z[k]), DRIFT_DT);
+    double sampleTime = Seconds() - start;
+
+    start = Seconds();
+    for (uint32_t r = 0; r < rounds; ++r)
+        GyroSpace_AccumulateAngleBatch(&ctx, x, y, z, DRIFT_DT, BATCH);
+    double batchTime = Seconds() - start;
+
+    volatile double doubleSink = ctx.angleX + ctx.angleY + ctx.angleZ;
+    (void)doubleSink;
+
+    const double scale = 1e9 / DRIFT_SAMPLES;
+    printf("ns/sample: float sum %.3f, AccumulateAngle %.3f, AccumulateAngleBatch %.3f\n",
+           floatTime * scale, sampleTime * scale, batchTime * scale);
+}
+
+int main(void) {
+    TestDrift();
+    TestBatchDrift();
+    Benchmark();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("angle_drift: ok\n");
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * AoS (packed float[3]) batch transform test and benchmark.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/aos_batch.c -lm -o aos_batch && ./aos_batch
+ *
+ * Checks the in-kernel transpose of GyroSpace_TransformToWorldSpaceArrayBatch
+ * and GyroSpace_TransformSensorToWorldSpaceBatch against the SoA batch path
+ * for every count from 0 to 9 (all SIMD/tail splits) and one large count,
+ * including that nothing past count is written. Then times the fused AoS
+ * call against copying to SoA and calling the SoA batch.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LARGE_COUNT 4099u
+#define BENCH_COUNT 65536u
+#define BENCH_ROUNDS 2000u
+#define SENTINEL 12345.0f
+#define TOLERANCE 1e-3f  // deg/s on inputs up to 500 deg/s; FMA may contract the SoA loop but not the shuffled kernel
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static double Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float Random(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return ((float)(*state >> 8) / 16777216.0f * 2.0f - 1.0f) * 500.0f;
+}
+
+static bool Near(float a, float b) {
+    return fabsf(a - b) <= TOLERANCE;
+}
+
+typedef struct {
+    float* xyz;              // count packed triplets
+    float* in[3];            // The same samples as SoA
+    float* out[3];           // AoS path output, count + 1 with a sentinel
+    float* ref[3];           // SoA path output
+} Buffers;
+
+static bool AllocBuffers(Buffers* b, size_t count) {
+    b->xyz = (float*)malloc(sizeof(float) * 3 * (count + 1));
+    bool ok = b->xyz != NULL;
+    for (int c = 0; c < 3; ++c) {
+        b->in[c] = (float*)malloc(sizeof(float) * (count + 1));
+        b->out[c] = (float*)malloc(sizeof(float) * (count + 1));
+        b->ref[c] = (float*)malloc(sizeof(float) * (count + 1));
+        ok = ok && b->in[c] && b->out[c] && b->ref[c];
+    }
+    return ok;
+}
+
+static void FreeBuffers(Buffers* b) {
+    free(b->xyz);
+    for (int c = 0; c < 3; ++c) {
+        free(b->in[c]);
+        free(b->out[c]);
+        free(b->ref[c]);
+    }
+}
+
+static void Fill(Buffers* b, size_t count, uint32_t seed) {
+    for (size_t i = 0; i < count; ++i)
+        for (int c = 0; c < 3; ++c)
+            b->in[c][i] = b->xyz[3 * i + c] = Random(&seed);
+    for (int c = 0; c < 3; ++c)
+        b->out[c][count] = SENTINEL;
+}
+
+/** Compares the AoS output with the SoA reference; returns the number of mismatching samples. */
+static size_t Compare(const Buffers* b, size_t count) {
+    size_t bad = 0;
+    for (size_t i = 0; i < count; ++i)
+        if (!Near(b->out[0][i], b->ref[0][i]) || !Near(b->out[1][i], b->ref[1][i]) || !Near(b->out[2][i], b->ref[2][i]))
+            bad++;
+    return bad;
+}
+
+static void TestCount(const GyroSpaceContext* ctx, size_t count) {
+    Buffers b;
+    if (!AllocBuffers(&b, count)) {
+        CHECK(!"out of memory");
+        FreeBuffers(&b);
+        return;
+    }
+
+    // (yaw, pitch, roll) triplets against the SoA World Space batch
+    Fill(&b, count, 17u + (uint32_t)count);
+    GyroSpace_TransformToWorldSpaceArrayBatch(ctx, b.xyz, b.out[0], b.out[1], b.out[2], count);
+    GyroSpace_TransformToWorldSpaceBatch(ctx, b.in[0], b.in[1], b.in[2], b.ref[0], b.ref[1], b.ref[2], count);
+    CHECK(Compare(&b, count) == 0);
+    CHECK(b.out[0][count] == SENTINEL && b.out[1][count] == SENTINEL && b.out[2][count] == SENTINEL);
+
+    // Raw sensor triplets against axis mapping followed by the SoA batch
+    Fill(&b, count, 91u + (uint32_t)count);
+    GyroSpace_TransformSensorToWorldSpaceBatch(ctx, b.xyz, b.out[0], b.out[1], b.out[2], count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 mapped = GyroSpace_MapSensorAxes(ctx, Vec3_New(b.in[0][i], b.in[1][i], b.in[2][i]));
+        b.in[0][i] = mapped.x;
+        b.in[1][i] = mapped.y;
+        b.in[2][i] = mapped.z;
+    }
+    GyroSpace_TransformToWorldSpaceBatch(ctx, b.in[0], b.in[1], b.in[2], b.ref[0], b.ref[1], b.ref[2], count);
+    // The combined matrix rounds differently from mapping then transforming
+    CHECK(Compare(&b, count) == 0);
+    CHECK(b.out[0][count] == SENTINEL && b.out[1][count] == SENTINEL && b.out[2][count] == SENTINEL);
+
+    FreeBuffers(&b);
+}
+
+static void Benchmark(const GyroSpaceContext* ctx) {
+    Buffers b;
+    if (!AllocBuffers(&b, BENCH_COUNT)) {
+        FreeBuffers(&b);
+        return;
+    }
+    Fill(&b, BENCH_COUNT, 5u);
+
+    double start = Seconds();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; ++r)
+        GyroSpace_TransformToWorldSpaceArrayBatch(ctx, b.xyz, b.out[0], b.out[1], b.out[2], BENCH_COUNT);
+    double fused = Seconds() - start;
+
+    start = Seconds();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; ++r) {
+        for (size_t i = 0; i < BENCH_COUNT; ++i) {
+            b.in[0][i] = b.xyz[3 * i];
+            b.in[1][i] = b.xyz[3 * i + 1];
+            b.in[2][i] = b.xyz[3 * i + 2];
+        }
+        GyroSpace_TransformToWorldSpaceBatch(ctx, b.in[0], b.in[1], b.in[2], b.ref[0], b.ref[1], b.ref[2], BENCH_COUNT);
+    }
+    double copied = Seconds() - start;
+
+    const double scale = 1e9 / ((double)BENCH_COUNT * BENCH_ROUNDS);
+    printf("ns/sample over %u samples: AoS kernel %.3f, copy to SoA + SoA batch %.3f (checksum %g)\n",
+           BENCH_COUNT, fused * scale, copied * scale, (double)(b.out[1][7] + b.ref[1][7]));
+    FreeBuffers(&b);
+}
+
+int main(void) {
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    GyroSpace_SetGravityVector(&ctx, 0.3f, 0.8f, 0.4f);
+
+    for (size_t count = 0; count <= 9; ++count)
+        TestCount(&ctx, count);
+    TestCount(&ctx, LARGE_COUNT);
+
+    // Same again with a posture whose axis mapping permutes and negates axes
+    GyroSpace_SetDynamicOrientation(&ctx, true, GYROSPACE_POSTURE_HYSTERESIS);
+    GyroSpace_SetGravityVector(&ctx, -0.95f, 0.1f, 0.2f);
+    CHECK(GyroSpace_GetPosture(&ctx) == GYROSPACE_POSTURE_PORTRAIT);
+    for (size_t count = 0; count <= 9; ++count)
+        TestCount(&ctx, count);
+    TestCount(&ctx, LARGE_COUNT);
+
+    Benchmark(&ctx);
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("aos_batch: ok\n");
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * Biquad filter test against a double-precision RBJ reference.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/biquad.c -lm -o biquad && ./biquad
+ *
+ * The reference designs each filter from the RBJ audio EQ cookbook with
+ * libm in double precision and runs it as a direct form I recurrence in
+ * double. The designed coefficients must match it, and the vector biquad,
+ * its batch form and the SoA bank must track it on noisy accel- and
+ * gyro-like signals for low-pass, high-pass and notch designs. Gains at
+ * the cutoff, notch centre and DC are checked against their closed forms,
+ * and ResetBiquad must start in the steady state for a constant input.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+
+#define SAMPLES 20000
+// Relative to the signal's peak magnitude. Cutoffs far below the sample rate
+// put the poles next to 1, where rounding a1 and a2 to float alone moves the
+// output by about 1e-4 of the signal
+#define TOLERANCE 2.5e-4
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static const double kPi = 3.14159265358979323846;
+
+static uint64_t rngState = 0x9FB21C651E98DF25ull;
+
+/** Uniform in [-1, 1). */
+static double Noise(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (double)(rngState >> 40) / (double)(1u << 23) - 1.0;
+}
+
+typedef struct {
+    double b0, b1, b2, a1, a2;
+    double x1, x2, y1, y2;
+} ReferenceBiquad;
+
+static void ReferenceDesign(ReferenceBiquad* f, GyroSpaceBiquadType type, double frequency, double q, double rate) {
+    double w = 2.0 * kPi * frequency / rate;
+    double c = cos(w), alpha = sin(w) / (2.0 * q), a0 = 1.0 + alpha;
+    switch (type) {
+    case GYROSPACE_BIQUAD_HIGHPASS:
+        f->b0 = f->b2 = (1.0 + c) / 2.0 / a0;
+        f->b1 = -(1.0 + c) / a0;
+        break;
+    case GYROSPACE_BIQUAD_NOTCH:
+        f->b0 = f->b2 = 1.0 / a0;
+        f->b1 = -2.0 * c / a0;
+        break;
+    default:
+        f->b0 = f->b2 = (1.0 - c) / 2.0 / a0;
+        f->b1 = (1.0 - c) / a0;
+        break;
+    }
+    f->a1 = -2.0 * c / a0;
+    f->a2 = (1.0 - alpha) / a0;
+    f->x1 = f->x2 = f->y1 = f->y2 = 0.0;
+}
+
+static double ReferenceFilter(ReferenceBiquad* f, double x) {
+    double y = f->b0 * x + f->b1 * f->x1 + f->b2 * f->x2 - f->a1 * f->y1 - f->a2 * f->y2;
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
+
+/** Gain of the reference design at a frequency, from its transfer function. */
+static double ReferenceGain(const ReferenceBiquad* f, double frequency, double rate) {
+    double w = 2.0 * kPi * frequency / rate;
+    double nr = f->b0 + f->b1 * cos(w) + f->b2 * cos(2.0 * w), ni = -f->b1 * sin(w) - f->b2 * sin(2.0 * w);
+    double dr = 1.0 + f->a1 * cos(w) + f->a2 * cos(2.0 * w), di = -f->a1 * sin(w) - f->a2 * sin(2.0 * w);
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+/** Accel-like input: gravity, slow tilt, controller rumble and sensor noise (per axis). */
+static double Signal(int i, int axis, double rate) {
+    double t = i / rate;
+    const double base[3] = { 0.1, -0.98, 0.15 };
+    return base[axis] + 0.2 * sin(t * (0.7 + axis)) + 0.3 * sin(2.0 * kPi * 160.0 * t + axis) + 0.05 * Noise();
+}
+
+typedef struct {
+    GyroSpaceBiquadType type;
+    float frequency, q, rate;
+    const char* name;
+} Design;
+
+static const Design designs[] = {
+    { GYROSPACE_BIQUAD_LOWPASS, 20.0f, 0.7071f, 1000.0f, "low-pass 20 Hz @ 1000" },
+    { GYROSPACE_BIQUAD_LOWPASS, 5.0f, 0.7071f, 833.0f, "low-pass 5 Hz @ 833" },
+    { GYROSPACE_BIQUAD_LOWPASS, 60.0f, 2.0f, 250.0f, "low-pass 60 Hz q2 @ 250" },
+    { GYROSPACE_BIQUAD_HIGHPASS, 2.0f, 0.7071f, 1000.0f, "high-pass 2 Hz @ 1000" },
+    { GYROSPACE_BIQUAD_HIGHPASS, 30.0f, 0.5f, 500.0f, "high-pass 30 Hz @ 500" },
+    { GYROSPACE_BIQUAD_NOTCH, 160.0f, 4.0f, 1000.0f, "notch 160 Hz @ 1000" },
+    { GYROSPACE_BIQUAD_NOTCH, 50.0f, 1.0f, 833.0f, "notch 50 Hz @ 833" },
+};
+
+static void TestDesign(const Design* d) {
+    ReferenceBiquad ref;
+    ReferenceDesign(&ref, d->type, d->frequency, d->q, d->rate);
+    GyroSpaceBiquadCoeffs k = GyroSpace_DesignBiquad(d->type, d->frequency, d->q, d->rate);
+    CHECK(fabs(k.b0 - ref.b0) < 1e-6 && fabs(k.b1 - ref.b1) < 1e-6 && fabs(k.b2 - ref.b2) < 1e-6);
+    CHECK(fabs(k.a1 - ref.a1) < 1e-6 && fabs(k.a2 - ref.a2) < 1e-6);
+}
+
+static void TestAgainstReference(const Design* d) {
+    enum { CHANNELS = 7 };   // Bank: one SIMD group of four plus a scalar tail
+    static float x[SAMPLES], y[SAMPLES], z[SAMPLES], ox[SAMPLES], oy[SAMPLES], oz[SAMPLES];
+    static float bankIn[SAMPLES][CHANNELS], bankOut[SAMPLES][CHANNELS];
+    ReferenceBiquad ref[CHANNELS];
+
+    rngState = 0x9FB21C651E98DF25ull;
+    for (int i = 0; i < SAMPLES; ++i) {
+        for (int c = 0; c < CHANNELS; ++c)
+            bankIn[i][c] = (float)Signal(i, c % 3, d->rate) * (1.0f + 0.25f * (float)(c / 3));
+        x[i] = bankIn[i][0];
+        y[i] = bankIn[i][1];
+        z[i] = bankIn[i][2];
+    }
+
+    GyroSpaceBiquad single, batch;
+    GyroSpace_InitBiquad(&single, d->type, d->frequency, d->q, d->rate);
+    GyroSpace_InitBiquad(&batch, d->type, d->frequency, d->q, d->rate);
+    GyroSpaceBiquadBank bank;
+    CHECK(GyroSpace_InitBiquadBank(&bank, CHANNELS, d->type, d->frequency, d->q, d->rate));
+    for (int c = 0; c < CHANNELS; ++c)
+        ReferenceDesign(&ref[c], d->type, d->frequency, d->q, d->rate);
+
+    GyroSpace_BiquadBatch(&batch, x, y, z, ox, oy, oz, SAMPLES);
+    GyroSpace_BiquadBankBatch(&bank, &bankIn[0][0], &bankOut[0][0], SAMPLES);
+
+    double worst = 0.0, peak = 1.5;
+    int batchMismatches = 0;
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 out = GyroSpace_Biquad(&single, Vec3_New(x[i], y[i], z[i]));
+        if (out.x != ox[i] || out.y != oy[i] || out.z != oz[i])
+            batchMismatches++;
+        const float* single3 = &out.x;
+        for (int c = 0; c < CHANNELS; ++c) {
+            double expected = ReferenceFilter(&ref[c], bankIn[i][c]);
+            worst = fmax(worst, fabs(bankOut[i][c] - expected) / peak);
+            if (c < 3)
+                worst = fmax(worst, fabs(single3[c] - expected) / peak);
+        }
+    }
+    printf("%-24s worst relative error %.3g\n", d->name, worst);
+    CHECK(worst < TOLERANCE);
+    CHECK(batchMismatches == 0);
+}
+
+/** Steady-state amplitude of a unit sine through the filter. */
+static double MeasuredGain(const Design* d, double frequency) {
+    GyroSpaceBiquad f;
+    GyroSpace_InitBiquad(&f, d->type, d->frequency, d->q, d->rate);
+    double peak = 0.0;
+    int settle = (int)(d->rate * 4.0), n = settle + (int)(d->rate * 2.0);
+    for (int i = 0; i < n; ++i) {
+        float in = (float)sin(2.0 * kPi * frequency * i / d->rate);
+        Vector3 out = GyroSpace_Biquad(&f, Vec3_New(in, 0.0f, 0.0f));
+        if (i >= settle)
+            peak = fmax(peak, fabs(out.x));
+    }
+    return peak;
+}
+
+static void TestResponse(void) {
+    // Butterworth low-pass and high-pass are 3 dB down at the cutoff
+    const Design* lp = &designs[0];
+    const Design* hp = &designs[3];
+    const Design* notch = &designs[5];
+    CHECK(fabs(MeasuredGain(lp, lp->frequency) - sqrt(0.5)) < 2e-3);
+    CHECK(fabs(MeasuredGain(hp, hp->frequency) - sqrt(0.5)) < 2e-3);
+    // Rumble at 160 Hz is removed by the notch and the 20 Hz low-pass alike
+    CHECK(MeasuredGain(notch, 160.0) < 1e-2);
+    ReferenceBiquad ref;
+    ReferenceDesign(&ref, lp->type, lp->frequency, lp->q, lp->rate);
+    CHECK(fabs(MeasuredGain(lp, 160.0) - ReferenceGain(&ref, 160.0, lp->rate)) < 2e-3);
+    // Far from the notch the signal passes
+    CHECK(fabs(MeasuredGain(notch, 10.0) - 1.0) < 2e-3);
+
+    // DC: low-pass and notch pass it, high-pass removes it
+    for (size_t d = 0; d < sizeof(designs) / sizeof(designs[0]); ++d) {
+        GyroSpaceBiquad f;
+        GyroSpace_InitBiquad(&f, designs[d].type, designs[d].frequency, designs[d].q, designs[d].rate);
+        Vector3 out = Vec3_New(0.0f, 0.0f, 0.0f);
+        for (int i = 0; i < (int)designs[d].rate * 10; ++i)
+            out = GyroSpace_Biquad(&f, Vec3_New(1.0f, -1.0f, 0.5f));
+        double expected = designs[d].type == GYROSPACE_BIQUAD_HIGHPASS ? 0.0 : 1.0;
+        CHECK(fabs(out.x - expected) < 1e-3 && fabs(out.y + expected) < 1e-3 && fabs(out.z - 0.5 * expected) < 1e-3);
+    }
+}
+
+static void TestReset(void) {
+    for (size_t d = 0; d < sizeof(designs) / sizeof(designs[0]); ++d) {
+        GyroSpaceBiquad f;
+        GyroSpace_InitBiquad(&f, designs[d].type, designs[d].frequency, designs[d].q, designs[d].rate);
+        Vector3 g = Vec3_New(0.1f, -0.98f, 0.15f);
+        GyroSpace_ResetBiquad(&f, g);
+        const GyroSpaceBiquadCoeffs* k = &f.coeffs;
+        float gain = (k->b0 + k->b1 + k->b2) / (1.0f + k->a1 + k->a2);
+        // A constant input stays at its steady-state output from the first sample
+        double worst = 0.0;
+        for (int i = 0; i < 1000; ++i) {
+            Vector3 out = GyroSpace_Biquad(&f, g);
+            worst = fmax(worst, fmax(fabs(out.x - g.x * gain), fmax(fabs(out.y - g.y * gain), fabs(out.z - g.z * gain))));
+        }
+        CHECK(worst < 1e-4);
+    }
+
+    GyroSpaceBiquadBank bank;
+    CHECK(!GyroSpace_InitBiquadBank(&bank, GYROSPACE_BIQUAD_BANK_MAX + 1, GYROSPACE_BIQUAD_LOWPASS, 20.0f, 0.7071f, 1000.0f));
+    CHECK(GyroSpace_InitBiquadBank(&bank, GYROSPACE_BIQUAD_BANK_MAX, GYROSPACE_BIQUAD_LOWPASS, 20.0f, 0.7071f, 1000.0f));
+}
+
+int main(void) {
+    for (size_t d = 0; d < sizeof(designs) / sizeof(designs[0]); ++d) {
+        TestDesign(&designs[d]);
+        TestAgainstReference(&designs[d]);
+    }
+    TestResponse();
+    TestReset();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("biquad: ok\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * Context pool test.
+ *
+ * Build and run from the repository root (gnu mode, Linux only):
+ *
+ *   cc -O2 -I. tests/context_pool.c -lm -o context_pool && ./context_pool
+ *
+ * Checks the acquire/release round trip, that a full pool returns
+ * GYROSPACE_INVALID_HANDLE, that pools over caller memory reject bad
+ * memory and stay safe to use afterwards, and that
+ * GyroSpaceMem_CreateContextPool works whether or not huge pages are
+ * reserved. When none are (the usual case), MAP_HUGETLB fails and the
+ * regular-page fallback is taken; the test reads /proc/self/smaps to check
+ * which kind of mapping it got.
+ */
+
+#include "GyroSpaceLinux.h"
+
+#include <stdio.h>
+
+#define CAPACITY 40u
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/** Reads a "Name: value" field from /proc/meminfo, or -1 if unavailable. */
+static long MemInfo(const char* name) {
+    FILE* f = fopen("/proc/meminfo", "r");
+    if (f == NULL)
+        return -1;
+    char line[256];
+    long value = -1;
+    size_t length = strlen(name);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (strncmp(line, name, length) == 0 && line[length] == ':') {
+            value = strtol(line + length + 1, NULL, 10);
+            break;
+        }
+    }
+    fclose(f);
+    return value;
+}
+
+/** Returns the kernel page size in kB backing the mapping at address, or -1. */
+static long MappingPageSize(const void* address) {
+    FILE* f = fopen("/proc/self/smaps", "r");
+    if (f == NULL)
+        return -1;
+    char line[512];
+    bool inMapping = false;
+    long pageSize = -1;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2 && strchr(line, '-') < strchr(line, ' ')) {
+            inMapping = (uintptr_t)address >= start && (uintptr_t)address < end;
+        } else if (inMapping && sscanf(line, "KernelPageSize: %ld kB", &pageSize) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return inMapping ? pageSize : -1;
+}
+
+/** Exercises a freshly created pool of CAPACITY contexts. */
+static void CheckPool(GyroSpaceContextPool* pool) {
+    CHECK(pool->capacity == CAPACITY);
+    CHECK(pool->count == 0);
+    CHECK(((uintptr_t)pool->contexts & (GYROSPACE_CACHE_LINE - 1)) == 0);
+
+    // A fresh pool hands out 0, 1, 2, ... until it is full
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        GyroSpaceContextHandle h = GyroSpace_AcquireContext(pool);
+        CHECK(h == i);
+        CHECK(GyroSpace_PoolContext(pool, h) == &pool->contexts[i]);
+    }
+    CHECK(pool->count == CAPACITY);
+    CHECK(GyroSpace_AcquireContext(pool) == GYROSPACE_INVALID_HANDLE);
+    CHECK(GyroSpace_AcquireContext(pool) == GYROSPACE_INVALID_HANDLE);
+    CHECK(pool->count == CAPACITY);
+
+    // Released contexts come back, most recently released first, reinitialized
+    GyroSpace_PoolContext(pool, 7)->angleX = 123.0;
+    GyroSpace_ReleaseContext(pool, 7);
+    GyroSpace_ReleaseContext(pool, 30);
+    CHECK(pool->count == CAPACITY - 2);
+    CHECK(!GyroSpace_ContextPoolIsLive(pool, 7));
+    CHECK(GyroSpace_PoolContext(pool, 30) == NULL);
+
+    // Releasing twice, or a handle that was never issued, changes nothing
+    GyroSpace_ReleaseContext(pool, 7);
+    GyroSpace_ReleaseContext(pool, CAPACITY);
+    GyroSpace_ReleaseContext(pool, GYROSPACE_INVALID_HANDLE);
+    CHECK(pool->count == CAPACITY - 2);
+
+    CHECK(GyroSpace_AcquireContext(pool) == 30);
+    CHECK(GyroSpace_AcquireContext(pool) == 7);
+    CHECK(GyroSpace_PoolContext(pool, 7)->angleX == 0.0);
+    CHECK(GyroSpace_AcquireContext(pool) == GYROSPACE_INVALID_HANDLE);
+
+    // Drain completely and refill: every slot is reachable again
+    for (uint32_t i = 0; i < CAPACITY; ++i)
+        GyroSpace_ReleaseContext(pool, i);
+    CHECK(pool->count == 0);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < CAPACITY; ++i) {
+        GyroSpaceContextHandle h = GyroSpace_AcquireContext(pool);
+        CHECK(h < CAPACITY);
+        if (h < CAPACITY)
+            seen++;
+    }
+    CHECK(seen == CAPACITY);
+    CHECK(GyroSpace_AcquireContext(pool) == GYROSPACE_INVALID_HANDLE);
+}
+
+static void TestHeapPool(void) {
+    GyroSpaceContextPool pool;
+    CHECK(GyroSpace_CreateContextPool(&pool, CAPACITY));
+    CheckPool(&pool);
+    GyroSpace_DestroyContextPool(&pool);
+    CHECK(pool.capacity == 0);
+    CHECK(GyroSpace_AcquireContext(&pool) == GYROSPACE_INVALID_HANDLE);
+}
+
+static void TestCallerMemory(void) {
+    static GYROSPACE_ALIGN(64) uint8_t memory[64 * 1024];
+    size_t needed = GyroSpace_ContextPoolBytes(CAPACITY);
+    CHECK(needed <= sizeof(memory));
+
+    GyroSpaceContextPool pool;
+    CHECK(GyroSpace_InitContextPool(&pool, memory, sizeof(memory), CAPACITY));
+    CheckPool(&pool);
+    // Nothing to free for caller-owned memory
+    GyroSpace_DestroyContextPool(&pool);
+
+    // Bad memory is rejected and the pool is left empty but usable
+    CHECK(!GyroSpace_InitContextPool(&pool, memory, needed - 1, CAPACITY));
+    CHECK(GyroSpace_AcquireContext(&pool) == GYROSPACE_INVALID_HANDLE);
+    CHECK(!GyroSpace_InitContextPool(&pool, memory + 8, sizeof(memory) - 64, CAPACITY));
+    CHECK(GyroSpace_AcquireContext(&pool) == GYROSPACE_INVALID_HANDLE);
+    CHECK(!GyroSpace_InitContextPool(&pool, NULL, sizeof(memory), CAPACITY));
+    CHECK(!GyroSpace_InitContextPool(&pool, memory, sizeof(memory), 0));
+    CHECK(GyroSpace_AcquireContext(&pool) == GYROSPACE_INVALID_HANDLE);
+    GyroSpace_ReleaseContext(&pool, 0);
+    CHECK(GyroSpace_PoolContext(&pool, 0) == NULL);
+    GyroSpace_DestroyContextPool(&pool);
+}
+
+static void TestMappedPool(void) {
+    long hugeFree = MemInfo("HugePages_Free");
+    long hugeSize = MemInfo("Hugepagesize");
+
+    GyroSpaceContextPool pool;
+    CHECK(GyroSpaceMem_CreateContextPool(&pool, CAPACITY));
+    CHECK(pool.allocationSize % GYROSPACE_HUGE_PAGE_SIZE == 0);
+    CHECK(pool.allocationSize >= GyroSpace_ContextPoolBytes(CAPACITY));
+
+    long pageSize = MappingPageSize(pool.contexts);
+    if (hugeFree == 0) {
+        // No huge pages reserved: MAP_HUGETLB fails, so this is the fallback mapping
+        CHECK(pageSize > 0 && pageSize < 2048);
+    }
+    printf("mapped pool: %s pages (%ld kB, %ld %ld kB huge pages free)\n",
+           pageSize == hugeSize ? "huge" : "regular", pageSize, hugeFree, hugeSize);
+
+    CheckPool(&pool);
+    GyroSpace_DestroyContextPool(&pool);
+    CHECK(pool.allocation == NULL);
+    CHECK(GyroSpace_AcquireContext(&pool) == GYROSPACE_INVALID_HANDLE);
+}
+
+int main(void) {
+    TestHeapPool();
+    TestCallerMemory();
+    TestMappedPool();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("context_pool: ok\n");
+    return 0;
+}
@@ -0,0 +1,58 @@
+#!/bin/sh
+# Builds tests/deterministic_trace.c with several compilers and flag sets
+# and runs each build; every one must reproduce the same output hash.
+# -ffp-contract=off is part of the deterministic build contract for GCC
+# (see GYROSPACE_DETERMINISTIC in GyroSpace.h), so it is passed to all,
+# together with the GYROSPACE_FP_CONTRACT_OFF define that confirms it.
+# Exits nonzero if any build fails or the hashes disagree.
+set -e
+
+cd "$(dirname "$0")/.."
+OUT=${TMPDIR:-/tmp}/gyrospace-deterministic
+mkdir -p "$OUT"
+
+status=0
+hashes=
+run() {
+    label=$1
+    shift
+    if "$@" -I. -ffp-contract=off -DGYROSPACE_FP_CONTRACT_OFF tests/deterministic_trace.c -lm -o "$OUT/build" 2>"$OUT/log"; then
+        "$OUT/build" >"$OUT/output" || status=1
+        hash=$(sed -n 's/.*hash \([0-9a-f]*\).*/\1/p' "$OUT/output")
+        printf '%-40s %s\n' "$label" "${hash:-no hash}"
+        case " $hashes " in *" $hash "*) ;; *) hashes="$hashes $hash" ;; esac
+    else
+        printf '%-40s build failed\n' "$label"
+        cat "$OUT/log"
+        status=1
+    fi
+}
+
+for cc in ${CC:-cc} clang; do
+    command -v "$cc" >/dev/null 2>&1 || continue
+    run "$cc -O0" "$cc" -O0
+    run "$cc -O2" "$cc" -O2
+    run "$cc -std=c99 -O3" "$cc" -std=c99 -O3
+    run "$cc -O3 -march=native" "$cc" -O3 -march=native
+done
+
+# Without the confirmation GCC must refuse an FMA build outright
+cc=${CC:-cc}
+if ! "$cc" -dM -E -x c /dev/null | grep -q __clang__ &&
+   "$cc" -O2 -mfma -I. tests/deterministic_trace.c -lm -o "$OUT/build" 2>/dev/null; then
+    printf '%-40s built without -DGYROSPACE_FP_CONTRACT_OFF\n' "$cc -O2 -mfma"
+    status=1
+fi
+
+for cxx in ${CXX:-c++} clang++; do
+    command -v "$cxx" >/dev/null 2>&1 || continue
+    run "$cxx -O2 (as C++)" "$cxx" -x c++ -O2
+    run "$cxx -std=c++20 -O3 -march=native" "$cxx" -x c++ -std=c++20 -O3 -march=native
+done
+
+set -- $hashes
+if [ $# -ne 1 ]; then
+    echo "deterministic_check: builds disagree:$hashes"
+    status=1
+fi
+exit $status
@@ -0,0 +1,173 @@
+/*
+ * GYROSPACE_DETERMINISTIC cross-build test.
+ *
+ * Records a synthetic session into a GyroSpaceTrace, decodes it and runs
+ * every sample through gravity fusion, axis mapping, the three transform
+ * spaces, One Euro, biquad, sinc resampling and angle accumulation, then
+ * hashes the bits of every output. The input is an integer random walk in
+ * sensor counts, so the decoded trace is exact on every platform and any
+ * difference in the hash comes from the processing.
+ *
+ * The hash must match EXPECTED_HASH for every compiler, optimization level
+ * and target that evaluates float in float precision.
+ * tests/deterministic_check.sh builds this file several ways and runs each
+ * build; on its own:
+ *
+ *   cc -O2 -ffp-contract=off -DGYROSPACE_FP_CONTRACT_OFF -I. tests/deterministic_trace.c -lm -o deterministic_trace && ./deterministic_trace
+ */
+
+#define GYROSPACE_DETERMINISTIC
+
+#include "GyroSpaceTrace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SESSION_SAMPLES 20000u
+#define SAMPLE_RATE 1000.0f
+#define GYRO_LSB (1.0f / 16.0f)
+#define ACCEL_LSB (1.0f / 8192.0f)
+#define EXPECTED_HASH 0x5208BCB9F017C264ull
+
+typedef struct {
+    uint64_t hash;
+} Hasher;
+
+/** FNV-1a over the bit patterns of the outputs. */
+static void HashBytes(Hasher* h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h->hash ^= p[i];
+        h->hash *= 0x100000001B3ull;
+    }
+}
+
+static void HashVec3(Hasher* h, Vector3 v) {
+    float f[3] = { v.x, v.y, v.z };
+    HashBytes(h, f, sizeof(f));
+}
+
+static uint32_t NextRandom(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 16;
+}
+
+/** Random walk step in counts: mostly small, occasionally a fast turn. */
+static int32_t Step(uint32_t* state, int32_t value, int32_t limit) {
+    int32_t r = (int32_t)(NextRandom(state) % 33u) - 16;
+    if ((NextRandom(state) & 255u) == 0)
+        r *= 40;
+    value += r;
+    if (value > limit) value = limit;
+    if (value < -limit) value = -limit;
+    return value;
+}
+
+static size_t RecordSession(uint8_t* buffer, size_t capacity) {
+    GyroSpaceTraceEncoder enc;
+    if (!GyroSpaceTrace_InitEncoder(&enc, buffer, capacity, GYRO_LSB, ACCEL_LSB, 1024))
+        return 0;
+
+    uint32_t rng = 12345u;
+    int32_t gyro[3] = { 0, 0, 0 };
+    int32_t accel[3] = { 0, 8192, 0 };
+    uint64_t t = 1000000;
+    for (uint32_t i = 0; i < SESSION_SAMPLES; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            gyro[c] = Step(&rng, gyro[c], 16 * 2000);
+            accel[c] = Step(&rng, accel[c], 8192 * 2);
+        }
+        // Rotate gravity from face-up towards upright partway through
+        if (i == SESSION_SAMPLES / 2) {
+            accel[1] = 0;
+            accel[2] = 8192;
+        }
+        t += 1000 + (NextRandom(&rng) % 5u) - 2;
+        Vector3 g = Vec3_New((float)gyro[0] * GYRO_LSB, (float)gyro[1] * GYRO_LSB, (float)gyro[2] * GYRO_LSB);
+        Vector3 a = Vec3_New((float)accel[0] * ACCEL_LSB, (float)accel[1] * ACCEL_LSB, (float)accel[2] * ACCEL_LSB);
+        if (!GyroSpaceTrace_Append(&enc, t, g, a))
+            return 0;
+    }
+    return GyroSpaceTrace_Finish(&enc);
+}
+
+int main(void) {
+    size_t capacity = (size_t)SESSION_SAMPLES * GYROSPACE_TRACE_MAX_SAMPLE_BYTES + 1024;
+    uint8_t* trace = (uint8_t*)malloc(capacity);
+    size_t size = trace ? RecordSession(trace, capacity) : 0;
+    if (size == 0) {
+        printf("deterministic_trace: could not record the session\n");
+        return 1;
+    }
+
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    GyroSpace_SetDynamicOrientation(&ctx, true, GYROSPACE_POSTURE_HYSTERESIS);
+    GyroSpace_SetGravityPolicy(&ctx, GYROSPACE_GRAVITY_FUSED);
+    GyroSpace_SetShakeRejection(&ctx, true, 1.0f, 0.2f);
+
+    GyroSpaceOneEuroFilter euro;
+    GyroSpace_InitOneEuroFilter(&euro, 1.0f, 0.05f, 1.0f, SAMPLE_RATE);
+    GyroSpaceBiquad notch;
+    GyroSpace_InitBiquad(&notch, GYROSPACE_BIQUAD_NOTCH, 120.0f, 4.0f, SAMPLE_RATE);
+    GyroSpaceResampler resampler;
+    GyroSpace_InitResampler(&resampler, GYROSPACE_RESAMPLE_SINC, SAMPLE_RATE, 144.0f, 8);
+
+    enum { BATCH = 256 };
+    uint64_t ts[BATCH];
+    float col[6][BATCH];
+    GyroSpaceTraceColumns columns = { ts, col[0], col[1], col[2], col[3], col[4], col[5] };
+    GyroSpaceTraceDecoder dec;
+    GyroSpaceTrace_InitDecoder(&dec, trace, size);
+
+    Hasher h = { 0xCBF29CE484222325ull };
+    size_t samples = 0, resampled = 0, n;
+    uint64_t prevTs = 0;
+    while ((n = GyroSpaceTrace_Decode(&dec, &columns, BATCH)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            float dt = prevTs ? (float)(ts[i] - prevTs) * 1e-6f : 1.0f / SAMPLE_RATE;
+            prevTs = ts[i];
+            Vector3 gyro = Vec3_New(col[0][i], col[1][i], col[2][i]);
+            Vector3 accel = Vec3_New(col[3][i], col[4][i], col[5][i]);
+
+            GyroSpace_UpdateGravity(&ctx, accel, gyro, 0.02f, dt);
+            SetGravityVector(ctx.gravNorm.x, ctx.gravNorm.y, ctx.gravNorm.z);
+            Vector3 mapped = GyroSpace_MapSensorAxes(&ctx, gyro);
+
+            Vector3 world = GyroSpace_TransformToWorldSpace(&ctx, mapped.x, mapped.y, mapped.z);
+            Vector3 player = TransformToPlayerSpace(mapped.x, mapped.y, mapped.z);
+            Vector3 local = TransformToLocalSpace(mapped.x, mapped.y, mapped.z, 0.3f);
+            Vector3 smooth = GyroSpace_Biquad(&notch, GyroSpace_OneEuroFilter(&euro, world));
+            GyroSpace_AccumulateAngle(&ctx, world, dt);
+
+            HashVec3(&h, ctx.gravNorm);
+            HashVec3(&h, world);
+            HashVec3(&h, player);
+            HashVec3(&h, local);
+            HashVec3(&h, smooth);
+
+            GyroSpace_ResamplerPush(&resampler, ts[i], world);
+            uint64_t outTime;
+            Vector3 out;
+            while (GyroSpace_ResamplerPop(&resampler, &outTime, &out)) {
+                HashBytes(&h, &outTime, sizeof(outTime));
+                HashVec3(&h, out);
+                resampled++;
+            }
+        }
+        samples += n;
+    }
+
+    Vector3 angle = GyroSpace_GetAccumulatedAngle(&ctx);
+    HashVec3(&h, angle);
+    free(trace);
+
+    printf("%zu samples, %zu resampled, posture %d, hash %016llx\n", samples, resampled, (int)ctx.posture,
+           (unsigned long long)h.hash);
+    if (samples != SESSION_SAMPLES || h.hash != EXPECTED_HASH) {
+        printf("deterministic_trace: FAIL (expected %016llx)\n", (unsigned long long)EXPECTED_HASH);
+        return 1;
+    }
+    printf("deterministic_trace: ok\n");
+    return 0;
+}
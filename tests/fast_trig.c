@@ -0,0 +1,234 @@
+/*
+ * Fast trig error sweep.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/fast_trig.c -lm -o fast_trig && ./fast_trig
+ *
+ * Sweeps GyroSpace_FastAtan2, FastAsin, FastAcos and FastSinCos over their
+ * input ranges in scalar, four-lane (_4, on SSE builds) and batch form, and
+ * checks the worst absolute error against double-precision libm stays
+ * within the bound documented in GyroSpace.h. The four-lane and batch
+ * forms are also checked against the scalar form so a lane or tail bug
+ * cannot hide under the bound.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Documented maximum absolute errors (see "Fast Math" in GyroSpace.h)
+#define ATAN2_BOUND 1.2e-5
+#define ASIN_BOUND 3e-7
+#define ACOS_BOUND 5e-7
+#define SINCOS_BOUND 1e-7
+#define SINCOS_RANGE 8192.0f
+
+// Batch forms are fed a length that is not a multiple of four to exercise the tail
+#define BATCH 1023u
+#define LANE_TOLERANCE 2e-7
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+typedef struct {
+    const char* name;
+    double worst;       // Largest error against libm
+    float worstInput;
+    double lane;        // Largest difference between the scalar and the _4/batch forms
+} ErrorStat;
+
+static void Record(ErrorStat* e, double error, float input) {
+    if (error > e->worst) {
+        e->worst = error;
+        e->worstInput = input;
+    }
+}
+
+static void RecordLane(ErrorStat* e, float scalar, float other) {
+    double d = fabs((double)scalar - (double)other);
+    if (d > e->lane)
+        e->lane = d;
+}
+
+static void Report(const ErrorStat* e, double bound) {
+    printf("%-8s max error %.3g (at %.9g), bound %.3g, scalar vs lanes %.3g\n",
+           e->name, e->worst, (double)e->worstInput, bound, e->lane);
+    CHECK(e->worst <= bound);
+    CHECK(e->lane <= LANE_TOLERANCE);
+}
+
+/** Angular distance, so atan2 results on either side of the +-pi seam compare equal. */
+static double AngleError(double a, double b) {
+    double d = fabs(a - b);
+    return d > 3.14159265358979 ? fabs(d - 2.0 * 3.14159265358979323846) : d;
+}
+
+static void TestAtan2(void) {
+    static float y[BATCH], x[BATCH], out[BATCH];
+    ErrorStat e = { "atan2", 0.0, 0.0f, 0.0 };
+
+    // Points on circles of several radii, including tiny and huge ones,
+    // then the axes and diagonals exactly
+    const float radii[] = { 1e-30f, 1e-6f, 0.5f, 1.0f, 3.0f, 1e6f, 1e30f };
+    const uint32_t steps = 1u << 20;
+    for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); ++r) {
+        for (uint32_t base = 0; base < steps; base += BATCH) {
+            uint32_t n = (steps - base < BATCH) ? steps - base : BATCH;
+            for (uint32_t k = 0; k < n; ++k) {
+                double a = (double)(base + k) / steps * 2.0 * 3.14159265358979323846 - 3.14159265358979323846;
+                y[k] = radii[r] * (float)sin(a);
+                x[k] = radii[r] * (float)cos(a);
+            }
+            GyroSpace_FastAtan2Batch(y, x, out, n);
+            for (uint32_t k = 0; k < n; ++k) {
+                float s = GyroSpace_FastAtan2(y[k], x[k]);
+                Record(&e, AngleError(s, atan2((double)y[k], (double)x[k])), (float)atan2((double)y[k], (double)x[k]));
+                RecordLane(&e, s, out[k]);
+            }
+        }
+    }
+
+    const float exact[][2] = { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, -1 }, { -1, 0 }, { -1, 1 } };
+    for (size_t i = 0; i < 8; ++i)
+        Record(&e, AngleError(GyroSpace_FastAtan2(exact[i][0], exact[i][1]), atan2(exact[i][0], exact[i][1])), (float)i);
+    CHECK(GyroSpace_FastAtan2(0.0f, 0.0f) == 0.0f);
+
+#if GYROSPACE_SSE
+    float lanes[4];
+    _mm_storeu_ps(lanes, GyroSpace_FastAtan2_4(_mm_setr_ps(0.0f, 1.0f, -1.0f, 0.25f), _mm_setr_ps(0.0f, -1.0f, 0.0f, 2.0f)));
+    CHECK(lanes[0] == 0.0f);
+    RecordLane(&e, GyroSpace_FastAtan2(1.0f, -1.0f), lanes[1]);
+    RecordLane(&e, GyroSpace_FastAtan2(-1.0f, 0.0f), lanes[2]);
+    RecordLane(&e, GyroSpace_FastAtan2(0.25f, 2.0f), lanes[3]);
+#endif
+
+    Report(&e, ATAN2_BOUND);
+}
+
+static void TestAsinAcos(void) {
+    static float x[BATCH], outAsin[BATCH], outAcos[BATCH];
+    ErrorStat es = { "asin", 0.0, 0.0f, 0.0 };
+    ErrorStat ec = { "acos", 0.0, 0.0f, 0.0 };
+
+    // Every step of 2^-22 across [-1, 1], plus the endpoints
+    const uint32_t steps = 1u << 23;
+    for (uint32_t base = 0; base <= steps; base += BATCH) {
+        uint32_t n = (steps + 1 - base < BATCH) ? steps + 1 - base : BATCH;
+        for (uint32_t k = 0; k < n; ++k)
+            x[k] = (float)((double)(base + k) / (steps / 2) - 1.0);
+        GyroSpace_FastAsinBatch(x, outAsin, n);
+        GyroSpace_FastAcosBatch(x, outAcos, n);
+        for (uint32_t k = 0; k < n; ++k) {
+            float s = GyroSpace_FastAsin(x[k]);
+            float c = GyroSpace_FastAcos(x[k]);
+            Record(&es, fabs((double)s - asin((double)x[k])), x[k]);
+            Record(&ec, fabs((double)c - acos((double)x[k])), x[k]);
+            RecordLane(&es, s, outAsin[k]);
+            RecordLane(&ec, c, outAcos[k]);
+        }
+    }
+
+    // Inputs just outside [-1, 1] (accelerometer noise) are clamped, not NaN
+    Record(&es, fabs((double)GyroSpace_FastAsin(1.0001f) - asin(1.0)), 1.0001f);
+    Record(&es, fabs((double)GyroSpace_FastAsin(-5.0f) - asin(-1.0)), -5.0f);
+    Record(&ec, fabs((double)GyroSpace_FastAcos(1.0001f) - acos(1.0)), 1.0001f);
+    Record(&ec, fabs((double)GyroSpace_FastAcos(-5.0f) - acos(-1.0)), -5.0f);
+
+#if GYROSPACE_SSE
+    float lanes[4];
+    __m128 v = _mm_setr_ps(-2.0f, -0.3f, 0.999f, 1.5f);
+    _mm_storeu_ps(lanes, GyroSpace_FastAsin_4(v));
+    RecordLane(&es, GyroSpace_FastAsin(-2.0f), lanes[0]);
+    RecordLane(&es, GyroSpace_FastAsin(-0.3f), lanes[1]);
+    RecordLane(&es, GyroSpace_FastAsin(0.999f), lanes[2]);
+    RecordLane(&es, GyroSpace_FastAsin(1.5f), lanes[3]);
+    _mm_storeu_ps(lanes, GyroSpace_FastAcos_4(v));
+    RecordLane(&ec, GyroSpace_FastAcos(-2.0f), lanes[0]);
+    RecordLane(&ec, GyroSpace_FastAcos(-0.3f), lanes[1]);
+    RecordLane(&ec, GyroSpace_FastAcos(0.999f), lanes[2]);
+    RecordLane(&ec, GyroSpace_FastAcos(1.5f), lanes[3]);
+#endif
+
+    Report(&es, ASIN_BOUND);
+    Report(&ec, ACOS_BOUND);
+}
+
+static void TestSinCos(void) {
+    static float x[BATCH], outSin[BATCH], outCos[BATCH];
+    ErrorStat es = { "sin", 0.0, 0.0f, 0.0 };
+    ErrorStat ec = { "cos", 0.0, 0.0f, 0.0 };
+
+    // Uniform sweep of [-8192, 8192], then the float neighbourhood of every
+    // multiple of pi/4 in range, where range reduction is hardest
+    const uint32_t steps = 1u << 24;
+    const uint32_t multiples = (uint32_t)(SINCOS_RANGE / (3.14159265358979 / 4.0));
+    for (int pass = 0; pass < 2; ++pass) {
+        uint32_t total = pass == 0 ? steps : (2 * multiples + 1) * 8;
+        for (uint32_t base = 0; base < total; base += BATCH) {
+            uint32_t n = (total - base < BATCH) ? total - base : BATCH;
+            for (uint32_t k = 0; k < n; ++k) {
+                uint32_t i = base + k;
+                if (pass == 0) {
+                    x[k] = (float)(((double)i / steps * 2.0 - 1.0) * SINCOS_RANGE);
+                } else {
+                    // Offsets of -3 to +4 ulps around the nearest float to k * pi/4
+                    double m = ((double)(i / 8) - multiples) * (3.14159265358979323846 / 4.0);
+                    float f = (float)m;
+                    int offset = (int)(i % 8) - 3;
+                    for (int u = 0; u < abs(offset); ++u)
+                        f = nextafterf(f, offset > 0 ? 1e9f : -1e9f);
+                    x[k] = f;
+                }
+            }
+            GyroSpace_FastSinCosBatch(x, outSin, outCos, n);
+            for (uint32_t k = 0; k < n; ++k) {
+                float s, c;
+                GyroSpace_FastSinCos(x[k], &s, &c);
+                Record(&es, fabs((double)s - sin((double)x[k])), x[k]);
+                Record(&ec, fabs((double)c - cos((double)x[k])), x[k]);
+                RecordLane(&es, s, outSin[k]);
+                RecordLane(&ec, c, outCos[k]);
+            }
+        }
+    }
+
+#if GYROSPACE_SSE
+    float lanesSin[4], lanesCos[4];
+    const float in[4] = { -SINCOS_RANGE, -1.5707964f, 3.1415927f, SINCOS_RANGE };
+    __m128 s4, c4;
+    GyroSpace_FastSinCos_4(_mm_loadu_ps(in), &s4, &c4);
+    _mm_storeu_ps(lanesSin, s4);
+    _mm_storeu_ps(lanesCos, c4);
+    for (int k = 0; k < 4; ++k) {
+        float s, c;
+        GyroSpace_FastSinCos(in[k], &s, &c);
+        RecordLane(&es, s, lanesSin[k]);
+        RecordLane(&ec, c, lanesCos[k]);
+    }
+#endif
+
+    Report(&es, SINCOS_BOUND);
+    Report(&ec, SINCOS_BOUND);
+}
+
+int main(void) {
+    TestAtan2();
+    TestAsinAcos();
+    TestSinCos();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("fast_trig: ok\n");
+    return 0;
+}
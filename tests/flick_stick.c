@@ -0,0 +1,145 @@
+/*
+ * Flick stick test.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/flick_stick.c -lm -o flick_stick && ./flick_stick
+ *
+ * Checks that a flick turns the camera by the stick angle, that rotating the
+ * held stick across the back (+-180 degrees) turns the short way, that a
+ * flick interrupted by a new one carries its unapplied rotation over, and
+ * that a long session of smoothed rotation leaves nothing behind in the
+ * smoothing window once the stick stops.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+
+#define DT 0.01f
+#define ANGLE_TOLERANCE 0.01   // Degrees; covers the FastAtan2 error
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/** Full deflection toward degrees clockwise from forward. */
+static float StickX(double degrees) { return (float)sin(degrees * (GYROSPACE_PI / 180.0)); }
+static float StickY(double degrees) { return (float)cos(degrees * (GYROSPACE_PI / 180.0)); }
+
+/** Runs count updates with the stick held at degrees; returns the summed yaw. */
+static double Hold(GyroSpaceFlickStick* fs, double degrees, int count) {
+    double total = 0.0;
+    for (int i = 0; i < count; ++i)
+        total += GyroSpace_UpdateFlickStick(fs, StickX(degrees), StickY(degrees), DT);
+    return total;
+}
+
+/** Runs count updates with the stick released; returns the summed yaw. */
+static double Release(GyroSpaceFlickStick* fs, int count) {
+    double total = 0.0;
+    for (int i = 0; i < count; ++i)
+        total += GyroSpace_UpdateFlickStick(fs, 0.0f, 0.0f, DT);
+    return total;
+}
+
+static void TestFlick(void) {
+    GyroSpaceFlickStick fs;
+    GyroSpace_InitFlickStick(&fs, 0.9f, 0.1f, 0.05f);
+
+    // 0.1 s animation at 100 Hz: the full quarter turn lands within a dozen updates
+    double turned = Hold(&fs, 90.0, 12);
+    CHECK(fabs(turned - 90.0) < ANGLE_TOLERANCE);
+    CHECK(fs.flickTarget == 0.0f);
+    CHECK(fabs(Hold(&fs, 90.0, 10)) < ANGLE_TOLERANCE);
+    CHECK(fabs(Release(&fs, 10)) < ANGLE_TOLERANCE);
+
+    // Below the threshold nothing happens
+    CHECK(GyroSpace_UpdateFlickStick(&fs, 0.5f, 0.0f, DT) == 0.0f);
+
+    // Flick backward-left
+    turned = Hold(&fs, -135.0, 20);
+    CHECK(fabs(turned + 135.0) < ANGLE_TOLERANCE);
+}
+
+static void TestRotationWrap(void) {
+    GyroSpaceFlickStick fs;
+    GyroSpace_InitFlickStick(&fs, 0.9f, 0.1f, 0.05f);
+
+    double turned = Hold(&fs, 170.0, 20);
+    CHECK(fabs(turned - 170.0) < ANGLE_TOLERANCE);
+
+    // Rotate clockwise from 170 to 190 (= -170) degrees in 2 degree steps:
+    // a +20 degree turn, not -340
+    turned = 0.0;
+    for (int step = 1; step <= 10; ++step)
+        turned += Hold(&fs, 170.0 + 2.0 * step, 1);
+    // Steps below the smoothing threshold arrive over the window
+    turned += Hold(&fs, 190.0, GYROSPACE_FLICK_SMOOTH_WINDOW);
+    CHECK(fabs(turned - 20.0) < ANGLE_TOLERANCE);
+
+    // And back counterclockwise in one large step
+    turned = Hold(&fs, 160.0, GYROSPACE_FLICK_SMOOTH_WINDOW + 1);
+    CHECK(fabs(turned + 30.0) < ANGLE_TOLERANCE);
+}
+
+static void TestInterruptedFlick(void) {
+    GyroSpaceFlickStick fs;
+    GyroSpace_InitFlickStick(&fs, 0.9f, 0.1f, 0.05f);
+
+    // Start a flick right, let go partway and flick forward before it lands
+    double turned = Hold(&fs, 90.0, 3);
+    CHECK(turned > 10.0 && turned < 80.0);
+    turned += Release(&fs, 1);
+    CHECK(turned < 80.0);
+    CHECK(fs.flickTarget != 0.0f);
+
+    // Forward adds no turn of its own; the unapplied rest of the first flick carries over
+    turned += Hold(&fs, 0.0, 20);
+    CHECK(fabs(turned - 90.0) < ANGLE_TOLERANCE);
+    CHECK(fs.flickTarget == 0.0f);
+
+    // Chained flicks add up
+    turned = Hold(&fs, 45.0, 2);
+    turned += Release(&fs, 1);
+    turned += Hold(&fs, -90.0, 20);
+    CHECK(fabs(turned + 45.0) < ANGLE_TOLERANCE);
+}
+
+static void TestSmoothingResidue(void) {
+    GyroSpaceFlickStick fs;
+    GyroSpace_InitFlickStick(&fs, 0.9f, 0.1f, 0.05f);
+    Hold(&fs, 0.0, 20);
+
+    // Hours of slow, uneven rotation, all of it below the smoothing threshold
+    double angle = 0.0;
+    for (int i = 0; i < 1000000; ++i) {
+        angle += 0.3 + 0.2 * sin(i * 0.37);
+        GyroSpace_UpdateFlickStick(&fs, StickX(angle), StickY(angle), DT);
+    }
+
+    // Once the stick stops and the window has emptied, the output is zero
+    Hold(&fs, angle, GYROSPACE_FLICK_SMOOTH_WINDOW);
+    float out = GyroSpace_UpdateFlickStick(&fs, StickX(angle), StickY(angle), DT);
+    CHECK(fabsf(out) < 1e-9f);
+}
+
+int main(void) {
+    TestFlick();
+    TestRotationWrap();
+    TestInterruptedFlick();
+    TestSmoothingResidue();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("flick_stick: ok\n");
+    return 0;
+}
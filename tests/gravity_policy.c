@@ -0,0 +1,100 @@
+/*
+ * Gravity source policy test.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/gravity_policy.c -lm -o gravity_policy && ./gravity_policy
+ *
+ * Rolls a simulated device at 90 deg/s for two seconds while its
+ * accelerometer also picks up uniform linear-motion noise, and measures
+ * the mean distance between each policy's gravity estimate and the true
+ * gravity direction. Also checks that a compile-time RAW policy keeps the
+ * global UpdateGravityVector behaviour, including the Y-up fallback.
+ */
+
+#define GYROSPACE_GRAVITY_POLICY GYROSPACE_GRAVITY_RAW
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+
+#define SAMPLE_RATE 1000.0f
+#define TURN_RATE 90.0f        // deg/s about sensor Z
+#define TURN_SAMPLES 2000
+#define NOISE 0.3f             // g, per axis
+#define FUSION 0.02f
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static float Noise(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return ((float)(*state >> 8) / 16777216.0f * 2.0f - 1.0f) * NOISE;
+}
+
+/** Mean |estimate - truth| over the turn for one policy. */
+static double MeanError(GyroSpaceGravityPolicy policy) {
+    const float dt = 1.0f / SAMPLE_RATE;
+    const Vector3 gyro = Vec3_New(0.0f, 0.0f, TURN_RATE);
+    Vector3 gravity = Vec3_New(0.0f, 1.0f, 0.0f);
+    uint32_t rng = 1u;
+    double sum = 0.0;
+
+    for (int i = 1; i <= TURN_SAMPLES; ++i) {
+        // The device turns by +angle, so gravity turns by -angle in sensor axes
+        double angle = -(double)TURN_RATE * i / SAMPLE_RATE * (GYROSPACE_PI / 180.0);
+        Vector3 truth = Vec3_New((float)-sin(angle), (float)cos(angle), 0.0f);
+        Vector3 accel = Vec3_New(truth.x + Noise(&rng), truth.y + Noise(&rng), truth.z + Noise(&rng));
+
+        GyroSpace_ApplyGravityPolicy(policy, &gravity, accel, gyro, FUSION, dt);
+        sum += Vec3_Magnitude(Vec3_Subtract(gravity, truth));
+    }
+    return sum / TURN_SAMPLES;
+}
+
+static void TestPolicyAccuracy(void) {
+    double raw = MeanError(GYROSPACE_GRAVITY_RAW);
+    double lowPass = MeanError(GYROSPACE_GRAVITY_LOWPASS);
+    double fused = MeanError(GYROSPACE_GRAVITY_FUSED);
+    printf("mean gravity error: raw %.3f, low-pass %.3f, fused %.3f\n", raw, lowPass, fused);
+
+    CHECK(fused < lowPass);
+    CHECK(lowPass < raw);
+    CHECK(fused < 0.05);
+}
+
+static void TestCompileTimeRaw(void) {
+    UpdateGravityVector(Vec3_New(0.0f, 0.0f, 2.0f), Vec3_New(0.0f, 0.0f, 0.0f), FUSION, 0.001f);
+    CHECK(GetGravityVector().z == 1.0f);
+
+    // Exactly (0, 0, 1) falls back to Y-up, as SetGravityVector always did
+    UpdateGravityVector(Vec3_New(0.0f, 0.0f, 1.0f), Vec3_New(0.0f, 0.0f, 0.0f), FUSION, 0.001f);
+    Vector3 g = GetGravityVector();
+    CHECK(g.x == 0.0f && g.y == 1.0f && g.z == 0.0f);
+
+    // Zero and tiny vectors are ignored
+    UpdateGravityVector(Vec3_New(2.0f, 0.0f, 0.0f), Vec3_New(0.0f, 0.0f, 0.0f), FUSION, 0.001f);
+    UpdateGravityVector(Vec3_New(0.0f, 0.0f, 0.0f), Vec3_New(0.0f, 0.0f, 0.0f), FUSION, 0.001f);
+    UpdateGravityVector(Vec3_New(1e-7f, 0.0f, 0.0f), Vec3_New(0.0f, 0.0f, 0.0f), FUSION, 0.001f);
+    g = GetGravityVector();
+    CHECK(g.x == 1.0f && g.y == 0.0f && g.z == 0.0f);
+}
+
+int main(void) {
+    TestPolicyAccuracy();
+    TestCompileTimeRaw();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("gravity_policy: ok\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * One Euro filter test against a double-precision reference.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/one_euro.c -lm -o one_euro && ./one_euro
+ *
+ * The reference is the filter as published by Casiez et al., one scalar
+ * filter per axis in double precision, with the low-pass smoothing factor
+ * written as 1 / (1 + tau / Te), tau = 1 / (2 pi fc). Three different
+ * signals (noisy hold, slow drift with jitter, fast flicks) run through
+ * the three lanes at once and each must track its own reference. The
+ * batch form must match the per-sample form exactly, and the filter must
+ * pass constants through, reset cleanly and survive a sample rate change.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLES 20000
+#define RATE 1000.0f
+#define TOLERANCE 1e-4       // Relative to the signal's peak magnitude
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+typedef struct {
+    double value, derivative;
+    bool initialized;
+} ReferenceOneEuro;
+
+static double ReferenceAlpha(double cutoff, double rate) {
+    double tau = 1.0 / (2.0 * 3.14159265358979323846 * cutoff);
+    return 1.0 / (1.0 + tau * rate);
+}
+
+static double ReferenceFilter(ReferenceOneEuro* f, double x, double minCutoff, double beta, double dCutoff, double rate) {
+    if (!f->initialized) {
+        f->value = x;
+        f->derivative = 0.0;
+        f->initialized = true;
+        return x;
+    }
+    double dx = (x - f->value) * rate;
+    f->derivative += ReferenceAlpha(dCutoff, rate) * (dx - f->derivative);
+    double cutoff = minCutoff + beta * fabs(f->derivative);
+    f->value += ReferenceAlpha(cutoff, rate) * (x - f->value);
+    return f->value;
+}
+
+static uint64_t rngState = 0xDA942042E4DD58B5ull;
+
+static float Noise(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (float)((double)(rngState >> 40) / (double)(1u << 23) - 1.0);
+}
+
+/** Per-axis test signals in deg/s: jittery hold, slow drift, fast flicks. */
+static Vector3 Signal(int i) {
+    float t = (float)i / RATE;
+    float hold = 0.5f * Noise();
+    float drift = 20.0f * sinf(t * 0.7f) + 2.0f * Noise();
+    float flick = ((i / 700) % 3 == 0) ? 900.0f * sinf((float)(i % 700) * 0.0045f) : 3.0f * Noise();
+    return Vec3_New(hold, drift, flick);
+}
+
+static void TestAgainstReference(float minCutoff, float beta, float dCutoff) {
+    GyroSpaceOneEuroFilter f;
+    GyroSpace_InitOneEuroFilter(&f, minCutoff, beta, dCutoff, RATE);
+    ReferenceOneEuro ref[3] = { { 0.0, 0.0, false }, { 0.0, 0.0, false }, { 0.0, 0.0, false } };
+
+    const double peak[3] = { 0.5, 22.0, 900.0 };
+    double worst[3] = { 0.0, 0.0, 0.0 };
+    rngState = 0xDA942042E4DD58B5ull;
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 in = Signal(i);
+        Vector3 out = GyroSpace_OneEuroFilter(&f, in);
+        const float x[3] = { in.x, in.y, in.z };
+        const float y[3] = { out.x, out.y, out.z };
+        for (int k = 0; k < 3; ++k) {
+            double expected = ReferenceFilter(&ref[k], x[k], minCutoff, beta, dCutoff, RATE);
+            double error = fabs(y[k] - expected) / peak[k];
+            if (error > worst[k])
+                worst[k] = error;
+        }
+    }
+    printf("minCutoff %.2f beta %.3f: worst relative error %.3g %.3g %.3g\n",
+           minCutoff, beta, worst[0], worst[1], worst[2]);
+    for (int k = 0; k < 3; ++k)
+        CHECK(worst[k] < TOLERANCE);
+}
+
+static void TestBatchMatchesSamples(void) {
+    static float x[SAMPLES], y[SAMPLES], z[SAMPLES], ox[SAMPLES], oy[SAMPLES], oz[SAMPLES];
+    rngState = 1;
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 s = Signal(i);
+        x[i] = s.x;
+        y[i] = s.y;
+        z[i] = s.z;
+    }
+
+    GyroSpaceOneEuroFilter a, b;
+    GyroSpace_InitOneEuroFilter(&a, 1.0f, 0.01f, 1.0f, RATE);
+    GyroSpace_InitOneEuroFilter(&b, 1.0f, 0.01f, 1.0f, RATE);
+    GyroSpace_OneEuroFilterBatch(&a, x, y, z, ox, oy, oz, SAMPLES);
+    int mismatches = 0;
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 out = GyroSpace_OneEuroFilter(&b, Vec3_New(x[i], y[i], z[i]));
+        if (out.x != ox[i] || out.y != oy[i] || out.z != oz[i])
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // In place
+    GyroSpace_ResetOneEuroFilter(&a);
+    GyroSpace_OneEuroFilterBatch(&a, x, y, z, x, y, z, SAMPLES);
+    CHECK(memcmp(x, ox, sizeof(x)) == 0 && memcmp(y, oy, sizeof(y)) == 0 && memcmp(z, oz, sizeof(z)) == 0);
+}
+
+static void TestBehaviour(void) {
+    GyroSpaceOneEuroFilter f;
+    GyroSpace_InitOneEuroFilter(&f, 1.0f, 0.01f, 1.0f, RATE);
+
+    // First sample passes through; a constant stays constant
+    Vector3 out = GyroSpace_OneEuroFilter(&f, Vec3_New(5.0f, -3.0f, 0.25f));
+    CHECK(out.x == 5.0f && out.y == -3.0f && out.z == 0.25f);
+    for (int i = 0; i < 100; ++i)
+        out = GyroSpace_OneEuroFilter(&f, Vec3_New(5.0f, -3.0f, 0.25f));
+    CHECK(out.x == 5.0f && out.y == -3.0f && out.z == 0.25f);
+
+    // A step is followed, not passed straight through, and converges
+    out = GyroSpace_OneEuroFilter(&f, Vec3_New(15.0f, -3.0f, 0.25f));
+    CHECK(out.x > 5.0f && out.x < 15.0f);
+    for (int i = 0; i < 5000; ++i)
+        out = GyroSpace_OneEuroFilter(&f, Vec3_New(15.0f, -3.0f, 0.25f));
+    CHECK(fabsf(out.x - 15.0f) < 1e-3f);
+
+    // After a reset the next sample passes through again
+    GyroSpace_ResetOneEuroFilter(&f);
+    out = GyroSpace_OneEuroFilter(&f, Vec3_New(-7.0f, 1.0f, 2.0f));
+    CHECK(out.x == -7.0f && out.y == 1.0f && out.z == 2.0f);
+
+    // A sample rate change keeps the state and follows the new rate
+    GyroSpace_SetOneEuroSampleRate(&f, 250.0f, 1.0f);
+    ReferenceOneEuro ref = { -7.0, 0.0, true };
+    for (int i = 0; i < 1000; ++i) {
+        float x = 10.0f * sinf((float)i * 0.02f);
+        out = GyroSpace_OneEuroFilter(&f, Vec3_New(x, 1.0f, 2.0f));
+        double expected = ReferenceFilter(&ref, x, 1.0, 0.01, 1.0, 250.0);
+        CHECK(fabs(out.x - expected) < 1e-3);
+    }
+}
+
+int main(void) {
+    TestAgainstReference(1.0f, 0.0f, 1.0f);
+    TestAgainstReference(1.0f, 0.01f, 1.0f);
+    TestAgainstReference(0.3f, 0.2f, 2.0f);
+    TestBatchMatchesSamples();
+    TestBehaviour();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("one_euro: ok\n");
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Dynamic orientation (posture hysteresis) test.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/posture.c -lm -o posture && ./posture
+ *
+ * Tilting gravity from one sensor axis toward another swaps the dominant
+ * axis at 45 degrees; with a hysteresis margin h, the posture should only
+ * change once the new axis leads by h, i.e. at 45 + asin(h / sqrt(2))
+ * degrees going out and 45 - asin(h / sqrt(2)) coming back. The test
+ * sweeps gravity between every pair of axes and checks the switch angles
+ * against that closed form, then replays a noisy random walk and checks
+ * every step against a plain reference classifier. It also checks that
+ * yaw follows the gravity axis in each posture.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define STEP_DEGREES 0.05
+#define ANGLE_TOLERANCE (2.0 * STEP_DEGREES)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static const double kPi = 3.14159265358979323846;
+
+/** Unit vector along sensor axis (0 = X, 1 = Y, 2 = Z) with the given sign. */
+static void Axis(int axis, double sign, double out[3]) {
+    out[0] = out[1] = out[2] = 0.0;
+    out[axis] = sign;
+}
+
+/** Posture the detector should settle on for gravity along an axis. */
+static GyroSpacePosture PostureForAxis(int axis) {
+    return axis == 1 ? GYROSPACE_POSTURE_FLAT : axis == 2 ? GYROSPACE_POSTURE_LANDSCAPE : GYROSPACE_POSTURE_PORTRAIT;
+}
+
+static void SetGravity(GyroSpaceContext* ctx, const double g[3]) {
+    GyroSpace_SetGravityVector(ctx, (float)g[0], (float)g[1], (float)g[2]);
+}
+
+/** Gravity tilted by degrees from axis a toward axis b. */
+static void Tilt(const double a[3], const double b[3], double degrees, double out[3]) {
+    double t = degrees * kPi / 180.0;
+    for (int i = 0; i < 3; ++i)
+        out[i] = a[i] * cos(t) + b[i] * sin(t);
+}
+
+/**
+ * Sweeps gravity from axis a to axis b and back in small steps and returns
+ * the angles (from a) at which the posture changed.
+ */
+static void SweepSwitchAngles(int axisA, double signA, int axisB, double signB, float h,
+                              double* outward, double* back, uint32_t* changes) {
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    GyroSpace_SetDynamicOrientation(&ctx, true, h);
+
+    double a[3], b[3], g[3];
+    Axis(axisA, signA, a);
+    Axis(axisB, signB, b);
+    SetGravity(&ctx, a);
+    CHECK(ctx.posture == PostureForAxis(axisA) && ctx.postureSign == (float)signA);
+    uint32_t start = ctx.postureChanges;
+
+    *outward = *back = -1.0;
+    for (double d = 0.0; d <= 90.0; d += STEP_DEGREES) {
+        Tilt(a, b, d, g);
+        SetGravity(&ctx, g);
+        if (*outward < 0.0 && ctx.posture == PostureForAxis(axisB))
+            *outward = d;
+    }
+    CHECK(ctx.posture == PostureForAxis(axisB) && ctx.postureSign == (float)signB);
+    for (double d = 90.0; d >= 0.0; d -= STEP_DEGREES) {
+        Tilt(a, b, d, g);
+        SetGravity(&ctx, g);
+        if (*back < 0.0 && ctx.posture == PostureForAxis(axisA))
+            *back = d;
+    }
+    CHECK(ctx.posture == PostureForAxis(axisA) && ctx.postureSign == (float)signA);
+    *changes = ctx.postureChanges - start;
+}
+
+static void TestSwitchAngles(void) {
+    const float margins[] = { 0.0f, 0.1f, GYROSPACE_POSTURE_HYSTERESIS, 0.4f };
+    for (size_t m = 0; m < sizeof(margins) / sizeof(margins[0]); ++m) {
+        float h = margins[m];
+        double offset = asin(h / sqrt(2.0)) * 180.0 / kPi;
+
+        for (int axisA = 0; axisA < 3; ++axisA) {
+            for (int axisB = 0; axisB < 3; ++axisB) {
+                if (axisA == axisB)
+                    continue;
+                for (int s = 0; s < 4; ++s) {
+                    double signA = (s & 1) ? -1.0 : 1.0, signB = (s & 2) ? -1.0 : 1.0;
+                    double outward, back;
+                    uint32_t changes;
+                    SweepSwitchAngles(axisA, signA, axisB, signB, h, &outward, &back, &changes);
+                    CHECK(fabs(outward - (45.0 + offset)) <= ANGLE_TOLERANCE);
+                    CHECK(fabs(back - (45.0 - offset)) <= ANGLE_TOLERANCE);
+                    // Exactly one change each way: no chatter while crossing
+                    CHECK(changes == 2);
+                }
+            }
+        }
+    }
+}
+
+/** Plain reference: (axis, sign) state, switching only when another axis leads by h. */
+typedef struct {
+    int axis;
+    double sign;
+} ReferencePosture;
+
+static void ReferenceUpdate(ReferencePosture* p, const float g[3], float h) {
+    float current = g[p->axis] * (float)p->sign;
+    int dominant = 1;
+    if (fabsf(g[2]) > fabsf(g[dominant])) dominant = 2;
+    if (fabsf(g[0]) > fabsf(g[dominant])) dominant = 0;
+    if (current > 0.0f && fabsf(g[dominant]) <= current + h)
+        return;
+    p->axis = dominant;
+    p->sign = g[dominant] >= 0.0f ? 1.0 : -1.0;
+}
+
+static void TestRandomWalk(void) {
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    GyroSpace_SetDynamicOrientation(&ctx, true, GYROSPACE_POSTURE_HYSTERESIS);
+    ReferencePosture ref = { 1, 1.0 };
+
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    double g[3] = { 0.0, 1.0, 0.0 };
+    uint32_t mismatches = 0;
+    for (int i = 0; i < 200000; ++i) {
+        // Wander with hand-tremor noise on top
+        for (int k = 0; k < 3; ++k) {
+            rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+            g[k] += ((double)(rng >> 40) / (double)(1u << 24) - 0.5) * 0.08;
+        }
+        double n = sqrt(g[0] * g[0] + g[1] * g[1] + g[2] * g[2]);
+        for (int k = 0; k < 3; ++k)
+            g[k] /= n;
+
+        SetGravity(&ctx, g);
+        const float gn[3] = { ctx.gravNorm.x, ctx.gravNorm.y, ctx.gravNorm.z };
+        ReferenceUpdate(&ref, gn, GYROSPACE_POSTURE_HYSTERESIS);
+        if (ctx.posture != PostureForAxis(ref.axis) || ctx.postureSign != (float)ref.sign)
+            mismatches++;
+
+        // Yaw always follows the axis gravity is nearest to
+        Vector3 yawAxis = Mat3_Row(&ctx.axisMatrix, 0);
+        CHECK(Vec3_Dot(yawAxis, ctx.gravNorm) > 0.4f);
+    }
+    printf("random walk: %u posture changes\n", ctx.postureChanges);
+    CHECK(mismatches == 0);
+    CHECK(ctx.postureChanges > 10);
+}
+
+static void TestAxisMatrices(void) {
+    const GyroSpacePosture postures[] = { GYROSPACE_POSTURE_FLAT, GYROSPACE_POSTURE_LANDSCAPE, GYROSPACE_POSTURE_PORTRAIT };
+    const int axes[] = { 1, 2, 0 };
+    for (int p = 0; p < 3; ++p) {
+        for (int s = 0; s < 2; ++s) {
+            float sign = s ? -1.0f : 1.0f;
+            Mat3 m = GyroSpace_BuildAxisMatrix(postures[p], sign);
+            // A signed permutation, so no sensor axis is dropped or doubled
+            Mat3 mmt = Mat3_Multiply(m, Mat3_Transpose(m));
+            Mat3 id = Mat3_Identity();
+            CHECK(memcmp(&mmt, &id, sizeof(Mat3)) == 0);
+            // Yaw is rotation about gravity
+            CHECK(m.m[0][axes[p]] == sign);
+        }
+    }
+
+    // The flat, face-up mapping is the README's (y, x, z) selection
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    Vector3 mapped = GyroSpace_MapSensorAxes(&ctx, Vec3_New(1.0f, 2.0f, 3.0f));
+    CHECK(mapped.x == 2.0f && mapped.y == 1.0f && mapped.z == 3.0f);
+
+    // With dynamic orientation off the posture never changes
+    GyroSpace_SetGravityVector(&ctx, 1.0f, 0.0f, 0.0f);
+    CHECK(ctx.posture == GYROSPACE_POSTURE_FLAT && ctx.postureChanges == 0);
+}
+
+int main(void) {
+    TestAxisMatrices();
+    TestSwitchAngles();
+    TestRandomWalk();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("posture: ok\n");
+    return 0;
+}
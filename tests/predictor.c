@@ -0,0 +1,250 @@
+/*
+ * Latency predictor test against a double-precision least-squares fit.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/predictor.c -lm -o predictor && ./predictor
+ *
+ * The reference fits a line or parabola to the window by solving the
+ * normal equations with Gaussian elimination in double precision, then
+ * applies the documented clamps (lead cap, overshoot factor, no zero
+ * crossing). Aiming-like signals with jittery Bluetooth-style timestamps
+ * run through every window size in both modes, and each prediction must
+ * match the reference. Signals that are exactly linear or quadratic must
+ * be extrapolated exactly, and each clamp is checked on its own.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+
+#define SAMPLES 20000
+#define TOLERANCE 1e-6        // Relative to the window's peak speed
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static uint64_t rngState = 0x853C49E6748FEA9Bull;
+
+/** Uniform in [-1, 1). */
+static double Noise(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (double)(rngState >> 40) / (double)(1u << 23) - 1.0;
+}
+
+/** Solves the n-by-n system a x = b in place by partial-pivot elimination. */
+static bool Solve(double a[3][3], double b[3], int n) {
+    for (int c = 0; c < n; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < n; ++r)
+            if (fabs(a[r][c]) > fabs(a[pivot][c]))
+                pivot = r;
+        if (fabs(a[pivot][c]) < 1e-12)
+            return false;
+        for (int k = 0; k < n; ++k) {
+            double t = a[c][k]; a[c][k] = a[pivot][k]; a[pivot][k] = t;
+        }
+        double t = b[c]; b[c] = b[pivot]; b[pivot] = t;
+        for (int r = c + 1; r < n; ++r) {
+            double f = a[r][c] / a[c][c];
+            for (int k = c; k < n; ++k)
+                a[r][k] -= f * a[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = n - 1; r >= 0; --r) {
+        for (int k = r + 1; k < n; ++k)
+            b[r] -= a[r][k] * b[k];
+        b[r] /= a[r][r];
+    }
+    return true;
+}
+
+/**
+ * The reference prediction for one axis from samples (t[i] in ms before the
+ * latest, y[i]), newest first.
+ */
+static double ReferencePredict(const double* t, const double* y, int count, bool quadratic,
+                               double lead, double overshootFactor) {
+    double latest = y[0], peak = 0.0;
+    for (int i = 0; i < count; ++i)
+        peak = fmax(peak, fabs(y[i]));
+    if (count < 2)
+        return latest;
+
+    int terms = (quadratic && count >= 3) ? 3 : 2;
+    double a[3][3] = { { 0 } }, b[3] = { 0 };
+    for (int i = 0; i < count; ++i) {
+        double basis[3] = { 1.0, t[i], t[i] * t[i] };
+        for (int r = 0; r < terms; ++r) {
+            for (int c = 0; c < terms; ++c)
+                a[r][c] += basis[r] * basis[c];
+            b[r] += basis[r] * y[i];
+        }
+    }
+    double predicted = latest;
+    if (Solve(a, b, terms))
+        predicted = b[0] + b[1] * lead + (terms == 3 ? b[2] * lead * lead : 0.0);
+
+    double limit = peak * overshootFactor;
+    predicted = fmin(fmax(predicted, -limit), limit);
+    if ((latest >= 0.0 && predicted < 0.0) || (latest <= 0.0 && predicted > 0.0))
+        predicted = 0.0;
+    return predicted;
+}
+
+static void TestAgainstReference(GyroSpacePredictMode mode, uint32_t window) {
+    const float maxLead = 0.02f, overshoot = 1.25f;
+    GyroSpacePredictor p;
+    GyroSpace_InitPredictor(&p, mode, window, maxLead, overshoot);
+
+    uint64_t times[GYROSPACE_PREDICT_MAX_WINDOW] = { 0 };
+    Vector3 values[GYROSPACE_PREDICT_MAX_WINDOW] = { { 0.0f, 0.0f, 0.0f } };
+    uint64_t now = 5000000;
+    double phase = 0.0, worst = 0.0;
+    rngState = 0x853C49E6748FEA9Bull + window * 2 + mode;
+    for (int i = 0; i < SAMPLES; ++i) {
+        // 1 kHz nominal with Bluetooth-like jitter and the odd dropped report
+        now += 1000 + (uint64_t)(300.0 * (Noise() + 1.0)) + ((i % 97 == 0) ? 4000 : 0);
+        phase += 0.004;
+        double turn = ((i / 1500) % 2 == 0) ? 600.0 * sin(phase) : 15.0 * sin(phase * 3.0);
+        Vector3 v = Vec3_New((float)(turn + Noise()), (float)(0.3 * turn + 2.0 * Noise()), (float)Noise());
+
+        GyroSpace_PredictorPush(&p, now, v);
+        for (int k = GYROSPACE_PREDICT_MAX_WINDOW - 1; k > 0; --k) {
+            times[k] = times[k - 1];
+            values[k] = values[k - 1];
+        }
+        times[0] = now;
+        values[0] = v;
+
+        uint64_t target = now + (uint64_t)(12000.0 * (Noise() + 1.0));   // 0-24 ms ahead
+        Vector3 out = GyroSpace_Predict(&p, target);
+
+        int count = (i + 1 < (int)p.window) ? i + 1 : (int)p.window;
+        double lead = fmin((double)(target - now) * 1e-3, maxLead * 1000.0);
+        double t[GYROSPACE_PREDICT_MAX_WINDOW], y[GYROSPACE_PREDICT_MAX_WINDOW];
+        for (int k = 0; k < count; ++k)
+            t[k] = -(double)(now - times[k]) * 1e-3;
+        const float* outAxes = &out.x;
+        for (int axis = 0; axis < 3; ++axis) {
+            double peak = 1.0;
+            for (int k = 0; k < count; ++k) {
+                y[k] = (&values[k].x)[axis];
+                peak = fmax(peak, fabs(y[k]));
+            }
+            double expected = ReferencePredict(t, y, count, mode == GYROSPACE_PREDICT_QUADRATIC, lead, overshoot);
+            double error = fabs(outAxes[axis] - expected) / peak;
+            if (error > worst)
+                worst = error;
+        }
+    }
+    printf("%s window %u: worst relative error %.3g\n",
+           mode == GYROSPACE_PREDICT_QUADRATIC ? "quadratic" : "linear   ", window, worst);
+    CHECK(worst < TOLERANCE);
+}
+
+static void TestExactPolynomials(void) {
+    GyroSpacePredictor lin, quad;
+    GyroSpace_InitPredictor(&lin, GYROSPACE_PREDICT_LINEAR, 6, 0.05f, 100.0f);
+    GyroSpace_InitPredictor(&quad, GYROSPACE_PREDICT_QUADRATIC, 6, 0.05f, 100.0f);
+    const uint64_t dt[] = { 1000, 1300, 800, 1250, 900, 1100 };
+    uint64_t now = 1000000;
+    for (int i = 0; i < 6; ++i) {
+        now += dt[i];
+        double ms = (double)now * 1e-3;
+        GyroSpace_PredictorPush(&lin, now, Vec3_New((float)(100.0 + 0.5 * (ms - 1000.0)), 10.0f, -20.0f));
+        double q = ms - 1000.0;
+        GyroSpace_PredictorPush(&quad, now, Vec3_New((float)(50.0 + 2.0 * q + 0.25 * q * q), 10.0f, -20.0f));
+    }
+    uint64_t target = now + 15000;
+    double q = (double)target * 1e-3 - 1000.0;
+    Vector3 a = GyroSpace_Predict(&lin, target);
+    Vector3 b = GyroSpace_Predict(&quad, target);
+    CHECK(fabs(a.x - (100.0 + 0.5 * q)) < 1e-3);
+    CHECK(fabs(b.x - (50.0 + 2.0 * q + 0.25 * q * q)) < 1e-2);
+    // Constant axes stay constant in both modes
+    CHECK(fabsf(a.y - 10.0f) < 1e-4f && fabsf(a.z + 20.0f) < 1e-4f);
+    CHECK(fabsf(b.y - 10.0f) < 1e-4f && fabsf(b.z + 20.0f) < 1e-4f);
+}
+
+static void TestClamps(void) {
+    GyroSpacePredictor p;
+
+    // Empty and single-sample predictors
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_QUADRATIC, 4, 0.02f, 1.25f);
+    Vector3 out = GyroSpace_Predict(&p, 1000);
+    CHECK(out.x == 0.0f && out.y == 0.0f && out.z == 0.0f);
+    GyroSpace_PredictorPush(&p, 1000, Vec3_New(3.0f, -4.0f, 5.0f));
+    out = GyroSpace_Predict(&p, 9000);
+    CHECK(out.x == 3.0f && out.y == -4.0f && out.z == 5.0f);
+
+    // Window is clamped to [2, GYROSPACE_PREDICT_MAX_WINDOW]
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_LINEAR, 0, 0.02f, 1.25f);
+    CHECK(p.window == 2);
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_LINEAR, 1000, 0.02f, 1.25f);
+    CHECK(p.window == GYROSPACE_PREDICT_MAX_WINDOW);
+
+    // Lead time is capped: 100 ms ahead predicts the same as 10 ms ahead
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_LINEAR, 4, 0.01f, 100.0f);
+    for (int i = 0; i < 4; ++i)
+        GyroSpace_PredictorPush(&p, 1000 * (uint64_t)(i + 1), Vec3_New(100.0f + 10.0f * i, 0.0f, 0.0f));
+    Vector3 capped = GyroSpace_Predict(&p, 4000 + 100000);
+    Vector3 atCap = GyroSpace_Predict(&p, 4000 + 10000);
+    CHECK(capped.x == atCap.x);
+    CHECK(fabsf(atCap.x - 230.0f) < 1e-3f);
+
+    // A target in the past extrapolates nothing beyond the fit at the latest sample
+    Vector3 past = GyroSpace_Predict(&p, 2000);
+    CHECK(fabsf(past.x - 130.0f) < 1e-3f);
+
+    // Overshoot: the same ramp with factor 1.25 is held to 1.25x the peak
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_LINEAR, 4, 0.02f, 1.25f);
+    for (int i = 0; i < 4; ++i)
+        GyroSpace_PredictorPush(&p, 1000 * (uint64_t)(i + 1), Vec3_New(100.0f + 30.0f * i, 0.0f, 0.0f));
+    out = GyroSpace_Predict(&p, 4000 + 20000);
+    CHECK(out.x == 190.0f * 1.25f);
+
+    // A stopping flick does not reverse direction
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_LINEAR, 5, 0.02f, 1.25f);
+    const float stopping[] = { 800.0f, 500.0f, 250.0f, 90.0f, 10.0f };
+    for (int i = 0; i < 5; ++i)
+        GyroSpace_PredictorPush(&p, 1000 * (uint64_t)(i + 1), Vec3_New(stopping[i], -stopping[i], 0.0f));
+    out = GyroSpace_Predict(&p, 5000 + 15000);
+    CHECK(out.x == 0.0f && out.y == 0.0f && out.z == 0.0f);
+
+    // Quadratic mode with two samples falls back to a line
+    GyroSpacePredictor lin;
+    GyroSpace_InitPredictor(&p, GYROSPACE_PREDICT_QUADRATIC, 4, 0.02f, 100.0f);
+    GyroSpace_InitPredictor(&lin, GYROSPACE_PREDICT_LINEAR, 4, 0.02f, 100.0f);
+    GyroSpace_PredictorPush(&p, 1000, Vec3_New(10.0f, 0.0f, 0.0f));
+    GyroSpace_PredictorPush(&p, 2000, Vec3_New(12.0f, 0.0f, 0.0f));
+    GyroSpace_PredictorPush(&lin, 1000, Vec3_New(10.0f, 0.0f, 0.0f));
+    GyroSpace_PredictorPush(&lin, 2000, Vec3_New(12.0f, 0.0f, 0.0f));
+    out = GyroSpace_Predict(&p, 7000);
+    Vector3 expected = GyroSpace_Predict(&lin, 7000);
+    CHECK(out.x == expected.x && fabsf(out.x - 22.0f) < 1e-4f);
+}
+
+int main(void) {
+    TestExactPolynomials();
+    TestClamps();
+    for (uint32_t window = 2; window <= GYROSPACE_PREDICT_MAX_WINDOW; ++window) {
+        TestAgainstReference(GYROSPACE_PREDICT_LINEAR, window);
+        TestAgainstReference(GYROSPACE_PREDICT_QUADRATIC, window);
+    }
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("predictor: ok\n");
+    return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Builds and runs every test program in this directory against the headers
+# in the repository root. C tests build with $CC, C++ tests with $CXX at
+# the language standard their header needs (C++17 for the pipeline,
+# C++20 for sample_stream). CC, CXX and CFLAGS may be overridden from the
+# environment, e.g. CFLAGS="-O3 -march=native" tests/run_tests.sh
+set -e
+
+cd "$(dirname "$0")/.."
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CFLAGS=${CFLAGS:--O2}
+OUT=${TMPDIR:-/tmp}/gyrospace-tests
+mkdir -p "$OUT"
+
+status=0
+for src in tests/*.c; do
+    name=$(basename "$src" .c)
+    echo "== $name"
+    # GCC only keeps FMA contraction out of deterministic builds when asked to
+    extra=
+    case $name in deterministic_*) extra='-ffp-contract=off -DGYROSPACE_FP_CONTRACT_OFF' ;; esac
+    if ! $CC -std=gnu99 $CFLAGS $extra -Wall -I. "$src" -lm -o "$OUT/$name"; then
+        status=1
+        continue
+    fi
+    "$OUT/$name" || status=1
+done
+
+for src in tests/*.cpp; do
+    name=$(basename "$src" .cpp)
+    echo "== $name"
+    std=c++17
+    case $name in sample_stream*) std=c++20 ;; esac
+    if ! $CXX -std=$std $CFLAGS -Wall -I. "$src" -o "$OUT/$name"; then
+        status=1
+        continue
+    fi
+    "$OUT/$name" || status=1
+done
+
+exit $status
@@ -0,0 +1,182 @@
+/*
+ * gyrospace::sample_stream test (C++20 coroutines).
+ *
+ * Build and run from the repository root:
+ *
+ *   c++ -std=c++20 -O2 -I. tests/sample_stream.cpp -o sample_stream && ./sample_stream
+ *
+ * Drives consumer coroutines from a producer on the same thread and checks
+ * batch handoff on flush, oldest-first dropping when the ring overflows,
+ * frame deltas (including a stream whose clock starts at 0), and that
+ * close() and destroying the stream both release a parked consumer.
+ */
+
+#include "GyroSpaceCpp.h"
+
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#if GYROSPACE_COROUTINES
+
+/** Minimal eagerly started coroutine; the handle is destroyed with the task. */
+struct task {
+    struct promise_type {
+        task get_return_object() { return task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() { handle.destroy(); }
+
+    bool done() const { return handle.done(); }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct BatchLog {
+    std::vector<std::vector<uint64_t>> batches;   // Timestamps per resumed batch
+    bool finished = false;
+};
+
+template <size_t Capacity>
+static task ConsumeBatches(gyrospace::sample_stream<Capacity>& stream, BatchLog& log) {
+    for (;;) {
+        auto batch = co_await stream.next_batch();
+        if (batch.empty())
+            break;
+        std::vector<uint64_t> stamps;
+        for (const gyrospace::sample& x : batch)
+            stamps.push_back(x.timestampUs);
+        log.batches.push_back(stamps);
+    }
+    log.finished = true;
+}
+
+static void TestBatchHandoff() {
+    gyrospace::sample_stream<16> stream;
+    BatchLog log;
+    task consumer = ConsumeBatches(stream, log);
+    CHECK(log.batches.empty() && !consumer.done());
+
+    // push() alone does not wake the consumer
+    stream.push(1, Vec3_New(1.0f, 0.0f, 0.0f));
+    stream.push(2, Vec3_New(2.0f, 0.0f, 0.0f));
+    stream.push(3, Vec3_New(3.0f, 0.0f, 0.0f));
+    CHECK(log.batches.empty());
+
+    // flush() runs the consumer inline with the whole batch
+    stream.flush();
+    CHECK(log.batches.size() == 1);
+    CHECK(log.batches.size() == 1 && log.batches[0] == std::vector<uint64_t>({ 1, 2, 3 }));
+
+    const gyrospace::sample more[2] = { { 4, Vec3_New(4.0f, 0.0f, 0.0f) }, { 5, Vec3_New(5.0f, 0.0f, 0.0f) } };
+    stream.publish(more, 2);
+    CHECK(log.batches.size() == 2 && log.batches[1] == std::vector<uint64_t>({ 4, 5 }));
+
+    // An empty flush does not resume
+    stream.flush();
+    CHECK(log.batches.size() == 2);
+
+    stream.close();
+    CHECK(log.finished && consumer.done());
+    CHECK(stream.closed());
+    CHECK(stream.dropped() == 0);
+}
+
+static void TestOverflow() {
+    gyrospace::sample_stream<4> stream;
+    BatchLog log;
+    task consumer = ConsumeBatches(stream, log);
+
+    for (uint64_t t = 1; t <= 6; ++t)
+        stream.push(t, Vec3_New((float)t, 0.0f, 0.0f));
+    CHECK(stream.dropped() == 2);
+    stream.flush();
+    // The two oldest samples were dropped
+    CHECK(log.batches.size() == 1 && log.batches[0] == std::vector<uint64_t>({ 3, 4, 5, 6 }));
+
+    stream.close();
+    CHECK(log.finished);
+}
+
+static task ConsumeDeltas(gyrospace::sample_stream<16>& stream, std::vector<gyrospace::frame_delta>& out) {
+    for (;;) {
+        gyrospace::frame_delta d = co_await stream.next_delta();
+        if (d.samples == 0)
+            break;
+        out.push_back(d);
+    }
+}
+
+static void TestFrameDelta() {
+    gyrospace::sample_stream<16> stream;
+    std::vector<gyrospace::frame_delta> deltas;
+    task consumer = ConsumeDeltas(stream, deltas);
+
+    // The clock starts at 0: the second sample still integrates over 1 ms
+    stream.push(0, Vec3_New(100.0f, 0.0f, 0.0f));
+    stream.push(1000, Vec3_New(100.0f, -50.0f, 0.0f));
+    stream.push(2000, Vec3_New(100.0f, -50.0f, 0.0f));
+    stream.flush();
+    CHECK(deltas.size() == 1);
+    CHECK(deltas.size() == 1 && deltas[0].samples == 3);
+    CHECK(deltas.size() == 1 && fabsf(deltas[0].delta.x - 0.2f) < 1e-6f && fabsf(deltas[0].delta.y + 0.1f) < 1e-6f);
+
+    // The gap to the previous batch's last sample counts as dt
+    stream.push(4000, Vec3_New(10.0f, 0.0f, 0.0f));
+    stream.flush();
+    CHECK(deltas.size() == 2 && fabsf(deltas[1].delta.x - 0.02f) < 1e-6f);
+
+    stream.close();
+    CHECK(consumer.done());
+}
+
+static void TestDestroyReleasesConsumer() {
+    BatchLog log;
+    auto* stream = new gyrospace::sample_stream<16>();
+    task consumer = ConsumeBatches(*stream, log);
+    CHECK(!consumer.done());
+
+    // The destructor closes the stream and the consumer runs to completion
+    delete stream;
+    CHECK(log.finished && consumer.done());
+}
+
+int main() {
+    TestBatchHandoff();
+    TestOverflow();
+    TestFrameDelta();
+    TestDestroyReleasesConsumer();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("sample_stream: ok\n");
+    return 0;
+}
+
+#else
+
+int main() {
+    printf("sample_stream: coroutines unavailable, skipped\n");
+    return 0;
+}
+
+#endif
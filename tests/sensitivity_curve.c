@@ -0,0 +1,130 @@
+/*
+ * Sensitivity curve table test against the analytic curves.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/sensitivity_curve.c -lm -o sensitivity_curve && ./sensitivity_curve
+ *
+ * Builds tables for a linear acceleration ramp (JoyShockMapper's
+ * min/max sensitivity between two speed thresholds), a power curve and an
+ * exponential ease, then sweeps speeds densely over the table range and
+ * beyond it. Each evaluation must stay within the requested epsilon of the
+ * analytic curve; the batch form must agree with the per-sample form, and
+ * speeds past the table, negative or NaN must clamp instead of reading
+ * outside it.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+
+#define SWEEP 1000000
+#define EPSILON_CURVE 1e-3f
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/** Acceleration ramp: minSens below lower, maxSens above upper, linear between. */
+static float RampCurve(float speed, void* userData) {
+    (void)userData;
+    float t = clamp((speed - 50.0f) / (150.0f - 50.0f), 0.0f, 1.0f);
+    return 0.8f + (2.5f - 0.8f) * t;
+}
+
+static float PowerCurve(float speed, void* userData) {
+    float exponent = *(const float*)userData;
+    return 1.0f + powf(speed / 500.0f, exponent);
+}
+
+static float ExpCurve(float speed, void* userData) {
+    (void)userData;
+    return 3.0f - 2.0f * expf(-speed / 120.0f);
+}
+
+static void CheckCurve(const char* name, GyroSpaceCurveFunc func, void* userData, float maxSpeed) {
+    static GyroSpaceSensitivityCurve curve;
+    CHECK(GyroSpace_BuildSensitivityCurve(&curve, func, userData, maxSpeed, EPSILON_CURVE));
+    CHECK(curve.maxError <= EPSILON_CURVE);
+    CHECK(curve.intervals >= 16 && curve.intervals <= GYROSPACE_CURVE_MAX_INTERVALS);
+
+    // Dense sweep over the table and 20% past its end
+    double worst = 0.0;
+    for (int i = 0; i <= SWEEP; ++i) {
+        float speed = (float)((double)i / SWEEP * 1.2 * maxSpeed);
+        float expected = func(fminf(speed, maxSpeed), userData);
+        double error = fabs((double)GyroSpace_EvalSensitivityCurve(&curve, speed) - expected);
+        if (error > worst)
+            worst = error;
+    }
+    printf("%-6s %4u intervals, build error %.3g, sweep error %.3g\n", name, curve.intervals, curve.maxError, worst);
+    // The build checks quarter points only; allow a little more between them
+    CHECK(worst <= 1.25 * EPSILON_CURVE);
+
+    // Applying scales the vector by the curve at its speed
+    Vector3 v = Vec3_New(30.0f, -40.0f, 0.0f);   // Speed 50
+    Vector3 out = GyroSpace_ApplySensitivityCurve(&curve, v);
+    float m = GyroSpace_EvalSensitivityCurve(&curve, 50.0f);
+    CHECK(fabsf(out.x - 30.0f * m) < 1e-4f && fabsf(out.y + 40.0f * m) < 1e-4f && out.z == 0.0f);
+
+    // Batch agrees with per-sample, including the tail and out-of-range speeds
+    enum { N = 1003 };
+    static float x[N], y[N], z[N], ox[N], oy[N], oz[N];
+    for (int i = 0; i < N; ++i) {
+        float s = (float)i / N * 1.5f * maxSpeed;
+        x[i] = s * 0.6f;
+        y[i] = -s * 0.64f;
+        z[i] = s * 0.48f;
+    }
+    GyroSpace_ApplySensitivityCurveBatch(&curve, x, y, z, ox, oy, oz, N);
+    double batchError = 0.0;
+    for (int i = 0; i < N; ++i) {
+        Vector3 s = GyroSpace_ApplySensitivityCurve(&curve, Vec3_New(x[i], y[i], z[i]));
+        double scale = fmax(1.0, Vec3_Magnitude(s));
+        batchError = fmax(batchError, fabs(s.x - ox[i]) / scale);
+        batchError = fmax(batchError, fabs(s.y - oy[i]) / scale);
+        batchError = fmax(batchError, fabs(s.z - oz[i]) / scale);
+    }
+    CHECK(batchError < 1e-6);
+
+    // Out-of-range speeds clamp to the table ends
+    CHECK(GyroSpace_EvalSensitivityCurve(&curve, -5.0f) == curve.values[0]);
+    CHECK(GyroSpace_EvalSensitivityCurve(&curve, NAN) == curve.values[0]);
+    CHECK(GyroSpace_EvalSensitivityCurve(&curve, INFINITY) == curve.values[curve.intervals]);
+    CHECK(GyroSpace_EvalSensitivityCurve(&curve, 1e30f) == curve.values[curve.intervals]);
+}
+
+static void TestUnreachableEpsilon(void) {
+    static GyroSpaceSensitivityCurve curve;
+    // Ramp corners that fall between table points cannot be matched exactly
+    CHECK(!GyroSpace_BuildSensitivityCurve(&curve, RampCurve, NULL, 1000.0f, 1e-9f));
+    CHECK(curve.intervals == GYROSPACE_CURVE_MAX_INTERVALS);
+    CHECK(curve.maxError > 1e-9f);
+
+    float exponent = 0.5f;   // Infinite slope at zero
+    bool met = GyroSpace_BuildSensitivityCurve(&curve, PowerCurve, &exponent, 1000.0f, 1e-7f);
+    CHECK(!met);
+    CHECK(curve.intervals == GYROSPACE_CURVE_MAX_INTERVALS);
+    CHECK(curve.maxError > 1e-7f);
+}
+
+int main(void) {
+    float exponent = 1.5f;
+    CheckCurve("ramp", RampCurve, NULL, 400.0f);
+    CheckCurve("power", PowerCurve, &exponent, 2000.0f);
+    CheckCurve("exp", ExpCurve, NULL, 1000.0f);
+    TestUnreachableEpsilon();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("sensitivity_curve: ok\n");
+    return 0;
+}
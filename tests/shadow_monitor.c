@@ -0,0 +1,180 @@
+/*
+ * Shadow accuracy monitor test and overhead benchmark.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/shadow_monitor.c -lm -o shadow_monitor && ./shadow_monitor
+ *
+ * Checks the three production transforms against the double-precision
+ * reference, that a deliberately divergent fast path is flagged, and that
+ * sampling never changes the production output. Then reports the cost of
+ * GyroSpace_ShadowSample at the default interval on a World Space plus
+ * One Euro loop.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SAMPLES 100000u
+#define BENCH_SAMPLES 10000000u
+#define TOLERANCE 1e-2f
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static double Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/** Gyro input in deg/s, up to +-500 per axis. */
+static Vector3 Input(uint32_t* state) {
+    float v[3];
+    for (int i = 0; i < 3; ++i) {
+        *state = *state * 1664525u + 1013904223u;
+        v[i] = ((float)(*state >> 8) / 16777216.0f * 2.0f - 1.0f) * 500.0f;
+    }
+    return Vec3_New(v[0], v[1], v[2]);
+}
+
+static Vector3 Production(GyroSpaceTransformSpace space, const GyroSpaceContext* ctx, Vector3 in) {
+    switch (space) {
+    case GYROSPACE_SPACE_LOCAL: return TransformToLocalSpace(in.x, in.y, in.z, 0.3f);
+    case GYROSPACE_SPACE_PLAYER: return GyroSpace_TransformToPlayerSpace(ctx, in.x, in.y, in.z);
+    default: return GyroSpace_TransformToWorldSpace(ctx, in.x, in.y, in.z);
+    }
+}
+
+static void InitTiltedContext(GyroSpaceContext* ctx) {
+    GyroSpace_InitContext(ctx);
+    GyroSpace_SetGravityVector(ctx, 0.2f, 0.9f, 0.35f);
+}
+
+static void TestFastPathsAgree(void) {
+    static const GyroSpaceTransformSpace spaces[3] = { GYROSPACE_SPACE_LOCAL, GYROSPACE_SPACE_PLAYER, GYROSPACE_SPACE_WORLD };
+    GyroSpaceContext ctx;
+    InitTiltedContext(&ctx);
+
+    for (int s = 0; s < 3; ++s) {
+        GyroSpaceShadowMonitor mon;
+        GyroSpace_InitShadowMonitor(&mon, spaces[s], 0.3f, 1, TOLERANCE);
+        uint32_t rng = 7u;
+        for (uint32_t i = 0; i < SAMPLES; ++i) {
+            Vector3 in = Input(&rng);
+            GyroSpace_ShadowSample(&mon, ctx.gravNorm, in.x, in.y, in.z, Production(spaces[s], &ctx, in));
+        }
+        printf("space %d: max deviation %.3g, mean %.3g\n", (int)spaces[s], mon.maxDeviation,
+               GyroSpace_ShadowMeanDeviation(&mon));
+        CHECK(mon.checks == SAMPLES);
+        CHECK(mon.exceedances == 0);
+        CHECK(mon.maxDeviation < 1e-3);
+    }
+}
+
+static void TestDivergenceFlagged(void) {
+    GyroSpaceContext ctx;
+    InitTiltedContext(&ctx);
+    GyroSpaceShadowMonitor mon;
+    GyroSpace_InitShadowMonitor(&mon, GYROSPACE_SPACE_WORLD, 0.0f, 1, TOLERANCE);
+
+    // A broken fast path: correct except for a 1% gain error on pitch above 100 deg/s
+    uint32_t rng = 11u;
+    uint64_t broken = 0;
+    for (uint32_t i = 0; i < SAMPLES; ++i) {
+        Vector3 in = Input(&rng);
+        Vector3 out = GyroSpace_TransformToWorldSpace(&ctx, in.x, in.y, in.z);
+        if (fabsf(in.y) > 100.0f) {
+            out.y *= 1.01f;
+            broken++;
+        }
+        GyroSpace_ShadowSample(&mon, ctx.gravNorm, in.x, in.y, in.z, out);
+    }
+    CHECK(mon.exceedances > 0);
+    CHECK(mon.exceedances <= broken);
+    CHECK(mon.maxDeviation > 1.0);
+    CHECK(fabsf(mon.worstInput.y) > 100.0f);
+}
+
+static void TestOutputUnchanged(void) {
+    GyroSpaceContext ctx;
+    InitTiltedContext(&ctx);
+    GyroSpaceOneEuroFilter plain, shadowed;
+    GyroSpace_InitOneEuroFilter(&plain, 1.0f, 0.05f, 1.0f, 1000.0f);
+    GyroSpace_InitOneEuroFilter(&shadowed, 1.0f, 0.05f, 1.0f, 1000.0f);
+    GyroSpaceShadowMonitor mon;
+    GyroSpace_InitShadowMonitor(&mon, GYROSPACE_SPACE_WORLD, 0.0f, 16, TOLERANCE);
+
+    uint32_t rng = 3u;
+    uint32_t differences = 0;
+    for (uint32_t i = 0; i < SAMPLES; ++i) {
+        Vector3 in = Input(&rng);
+        Vector3 a = GyroSpace_OneEuroFilter(&plain, GyroSpace_TransformToWorldSpace(&ctx, in.x, in.y, in.z));
+        Vector3 world = GyroSpace_TransformToWorldSpace(&ctx, in.x, in.y, in.z);
+        GyroSpace_ShadowSample(&mon, ctx.gravNorm, in.x, in.y, in.z, world);
+        Vector3 b = GyroSpace_OneEuroFilter(&shadowed, world);
+        if (memcmp(&a, &b, sizeof(a)) != 0)
+            differences++;
+    }
+    CHECK(differences == 0);
+    CHECK(mon.checks == SAMPLES / 16);
+}
+
+static void BenchmarkOverhead(void) {
+    GyroSpaceContext ctx;
+    InitTiltedContext(&ctx);
+    GyroSpaceOneEuroFilter filter;
+    GyroSpaceShadowMonitor mon;
+    GyroSpace_InitShadowMonitor(&mon, GYROSPACE_SPACE_WORLD, 0.0f, GYROSPACE_SHADOW_INTERVAL, TOLERANCE);
+
+    // Best of five interleaved passes each way
+    double best[2] = { 1e30, 1e30 };
+    float sink = 0.0f;
+    for (int pass = 0; pass < 10; ++pass) {
+        int shadow = pass & 1;
+        GyroSpace_InitOneEuroFilter(&filter, 1.0f, 0.05f, 1.0f, 1000.0f);
+        uint32_t rng = 5u;
+        double start = Seconds();
+        for (uint32_t i = 0; i < BENCH_SAMPLES; ++i) {
+            Vector3 in = Input(&rng);
+            Vector3 world = GyroSpace_TransformToWorldSpace(&ctx, in.x, in.y, in.z);
+            if (shadow)
+                GyroSpace_ShadowSample(&mon, ctx.gravNorm, in.x, in.y, in.z, world);
+            sink += GyroSpace_OneEuroFilter(&filter, world).x;
+        }
+        double elapsed = Seconds() - start;
+        if (elapsed < best[shadow])
+            best[shadow] = elapsed;
+    }
+
+    const double scale = 1e9 / BENCH_SAMPLES;
+    printf("ns/sample: plain %.3f, with shadow monitor %.3f (%+.2f%%, %llu checks, checksum %g)\n",
+           best[0] * scale, best[1] * scale, (best[1] / best[0] - 1.0) * 100.0,
+           (unsigned long long)mon.checks, (double)sink);
+}
+
+int main(void) {
+    TestFastPathsAgree();
+    TestDivergenceFlagged();
+    TestOutputUnchanged();
+    BenchmarkOverhead();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("shadow_monitor: ok\n");
+    return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Shared-memory channel stress test and handoff latency measurement.
+ *
+ * Build and run from the repository root (gnu mode, Linux only):
+ *
+ *   cc -O2 -I. tests/shm_stress.c -lm -o shm_stress && ./shm_stress
+ *
+ * A writer process publishes while a reader in the parent copies samples
+ * out, in three passes:
+ *
+ *   torn     a deliberately tiny ring and an unpaced writer, so the writer
+ *            laps the reader constantly; every accepted sample must still
+ *            be whole (all fields from one publish) and in order
+ *   paced    a large ring with the writer held back while the ring is
+ *            full; at least MIN_ACCEPTED_PERCENT must arrive
+ *   latency  one sample at a time, stamped with CLOCK_MONOTONIC on
+ *            publish; reports the publish-to-read time. Sub-microsecond
+ *            handoff needs writer and reader on separate cores, so on a
+ *            single CPU this mostly measures the scheduler.
+ *
+ * In every pass accepted plus dropped samples must account for everything
+ * published. Also checks that a failed GyroSpaceShm_AttachReader closes
+ * the fds it was given.
+ */
+
+#define _GNU_SOURCE
+
+#include "GyroSpaceLinux.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+
+#define PUBLISH_TOTAL 4000000u
+#define TORN_CAPACITY 16u
+#define PACED_CAPACITY 65536u
+#define MIN_ACCEPTED_PERCENT 99u
+#define LATENCY_SAMPLES 20000u
+#define SPINS_BEFORE_YIELD 4096
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static bool IsClosed(int fd) {
+    return fcntl(fd, F_GETFD) < 0 && errno == EBADF;
+}
+
+static void TestAttachFailureClosesFds(void) {
+    GyroSpaceSharedReader r;
+
+    // Too small to hold a channel header
+    int shmFd = (int)syscall(SYS_memfd_create, "gyrospace-empty", MFD_CLOEXEC);
+    int eventFd = eventfd(0, EFD_CLOEXEC);
+    CHECK(shmFd >= 0 && eventFd >= 0);
+    CHECK(!GyroSpaceShm_AttachReader(&r, shmFd, eventFd, 0));
+    CHECK(errno == EINVAL);
+    CHECK(IsClosed(shmFd) && IsClosed(eventFd));
+    CHECK(r.shmFd == -1 && r.eventFd == -1 && r.header == NULL);
+
+    // Header-sized but never initialized by a writer
+    shmFd = (int)syscall(SYS_memfd_create, "gyrospace-blank", MFD_CLOEXEC);
+    eventFd = eventfd(0, EFD_CLOEXEC);
+    CHECK(shmFd >= 0 && eventFd >= 0 && ftruncate(shmFd, (off_t)GyroSpaceShm_MappedSize(16)) == 0);
+    CHECK(!GyroSpaceShm_AttachReader(&r, shmFd, eventFd, 0));
+    CHECK(IsClosed(shmFd) && IsClosed(eventFd));
+
+    // Slot out of range
+    GyroSpaceSharedWriter w;
+    CHECK(GyroSpaceShm_CreateWriter(&w, NULL, 16));
+    shmFd = dup(w.shmFd);
+    eventFd = eventfd(0, EFD_CLOEXEC);
+    CHECK(!GyroSpaceShm_AttachReader(&r, shmFd, eventFd, GYROSPACE_SHM_MAX_READERS));
+    CHECK(IsClosed(shmFd) && IsClosed(eventFd));
+    GyroSpaceShm_DestroyWriter(&w, NULL);
+}
+
+
+static GyroSpaceSharedSample MakeSample(uint64_t i) {
+    GyroSpaceSharedSample s;
+    float f = (float)(i & 0xFFFFFF);   // Exact in a float
+    s.timestamp = i;
+    s.output = Vec3_New(f, -f, f * 0.5f);
+    s.deviceId = (uint32_t)i;
+    return s;
+}
+
+static bool IsWhole(const GyroSpaceSharedSample* s) {
+    float f = (float)(s->timestamp & 0xFFFFFF);
+    return s->deviceId == (uint32_t)s->timestamp && s->output.x == f && s->output.y == -f && s->output.z == f * 0.5f;
+}
+
+static uint64_t NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static long cpuCount = 1;
+
+/** Busy-waits a while, then starts yielding; on a single CPU yields at once so the other side can run. */
+static void Backoff(int* spins) {
+    if (cpuCount < 2 || ++*spins >= SPINS_BEFORE_YIELD)
+        sched_yield();
+}
+
+static uint64_t ReaderCursor(const GyroSpaceSharedWriter* w, int slot) {
+    return __atomic_load_n(&w->header->readers[slot].cursor, __ATOMIC_ACQUIRE);
+}
+
+static void RunWriter(GyroSpaceSharedWriter* w, int slot, bool paced) {
+    GyroSpaceSharedSample batch[7];
+    uint64_t next = 0;
+    while (next < PUBLISH_TOTAL) {
+        // Batches of 1-7 samples, so slots are reserved at every offset
+        size_t count = 1 + (size_t)(next % 7);
+        if (count > PUBLISH_TOTAL - next)
+            count = (size_t)(PUBLISH_TOTAL - next);
+        int spins = 0;
+        while (paced && next + count - ReaderCursor(w, slot) > w->header->capacity)
+            Backoff(&spins);
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = MakeSample(next + i);
+        GyroSpaceShm_Publish(w, batch, count);
+        next += count;
+    }
+}
+
+static void RunLatencyWriter(GyroSpaceSharedWriter* w, int slot) {
+    for (uint64_t i = 0; i < LATENCY_SAMPLES; ++i) {
+        // Wait for the previous sample to be consumed, so each one is timed alone
+        int spins = 0;
+        while (ReaderCursor(w, slot) != i)
+            Backoff(&spins);
+        GyroSpaceSharedSample s = MakeSample(i);
+        s.timestamp = NowNs();
+        s.deviceId = (uint32_t)i;
+        GyroSpaceShm_Publish(w, &s, 1);
+    }
+}
+
+typedef struct {
+    uint64_t accepted, dropped, torn, reordered;
+} StressResult;
+
+typedef enum { PASS_TORN, PASS_PACED, PASS_LATENCY } Pass;
+
+static int CompareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/** Runs one pass with a fresh channel; returns false if the channel could not be set up. */
+static bool RunPass(Pass pass, uint32_t capacity, StressResult* result) {
+    memset(result, 0, sizeof(*result));
+    GyroSpaceSharedWriter w;
+    if (!GyroSpaceShm_CreateWriter(&w, NULL, capacity)) {
+        printf("shm_stress: cannot create channel (%s)\n", strerror(errno));
+        return false;
+    }
+    int slot = GyroSpaceShm_ClaimReaderSlot(&w);
+
+    GyroSpaceSharedReader r;
+    if (slot < 0 || !GyroSpaceShm_AttachReader(&r, dup(w.shmFd), -1, (uint32_t)slot)) {
+        printf("shm_stress: cannot attach reader (%s)\n", strerror(errno));
+        GyroSpaceShm_DestroyWriter(&w, NULL);
+        return false;
+    }
+
+    const uint64_t total = pass == PASS_LATENCY ? LATENCY_SAMPLES : PUBLISH_TOTAL;
+    uint64_t* latencies = pass == PASS_LATENCY ? (uint64_t*)malloc(sizeof(uint64_t) * LATENCY_SAMPLES) : NULL;
+
+    pid_t child = fork();
+    if (child == 0) {
+        if (pass == PASS_LATENCY)
+            RunLatencyWriter(&w, slot);
+        else
+            RunWriter(&w, slot, pass == PASS_PACED);
+        _exit(0);
+    }
+
+    uint64_t last = 0;
+    bool any = false;
+    int spins = 0;
+    GyroSpaceSharedSample out[64];
+    while (result->accepted + result->dropped < total) {
+        uint64_t lost;
+        size_t n = GyroSpaceShm_Read(&r, out, pass == PASS_TORN ? TORN_CAPACITY : 64, &lost);
+        uint64_t now = n && latencies ? NowNs() : 0;
+        result->dropped += lost;
+        for (size_t i = 0; i < n; ++i) {
+            if (latencies) {
+                if (result->accepted + i < LATENCY_SAMPLES)
+                    latencies[result->accepted + i] = now - out[i].timestamp;
+                continue;
+            }
+            if (!IsWhole(&out[i]))
+                result->torn++;
+            if (any && out[i].timestamp <= last)
+                result->reordered++;
+            last = out[i].timestamp;
+            any = true;
+        }
+        result->accepted += n;
+        if (n == 0 && lost == 0) {
+            // Once the writer has exited, an empty read means the ring is drained
+            if (child < 0)
+                break;
+            if (waitpid(child, NULL, WNOHANG) == child)
+                child = -1;
+            if (pass != PASS_TORN)
+                Backoff(&spins);
+        } else {
+            spins = 0;
+        }
+    }
+    if (child > 0)
+        waitpid(child, NULL, 0);
+
+    if (latencies) {
+        size_t count = (size_t)result->accepted;
+        qsort(latencies, count, sizeof(uint64_t), CompareU64);
+        if (count > 0)
+            printf("latency: %zu handoffs, median %.0f ns, p99 %.0f ns, %ld CPU(s)\n", count,
+                   (double)latencies[count / 2], (double)latencies[count * 99 / 100], cpuCount);
+        free(latencies);
+    } else {
+        printf("%-6s ring %6u: published %u, accepted %llu (%.2f%%), dropped %llu, torn %llu, out of order %llu\n",
+               pass == PASS_TORN ? "torn" : "paced", capacity, PUBLISH_TOTAL, (unsigned long long)result->accepted,
+               100.0 * (double)result->accepted / PUBLISH_TOTAL, (unsigned long long)result->dropped,
+               (unsigned long long)result->torn, (unsigned long long)result->reordered);
+    }
+
+    GyroSpaceShm_DetachReader(&r);
+    GyroSpaceShm_DestroyWriter(&w, NULL);
+    return true;
+}
+
+int main(void) {
+    cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    TestAttachFailureClosesFds();
+
+    StressResult torn;
+    CHECK(RunPass(PASS_TORN, TORN_CAPACITY, &torn));
+    CHECK(torn.torn == 0);
+    CHECK(torn.reordered == 0);
+    CHECK(torn.accepted + torn.dropped == PUBLISH_TOTAL);
+    CHECK(torn.accepted > 0);
+
+    StressResult paced;
+    CHECK(RunPass(PASS_PACED, PACED_CAPACITY, &paced));
+    CHECK(paced.torn == 0);
+    CHECK(paced.reordered == 0);
+    CHECK(paced.accepted + paced.dropped == PUBLISH_TOTAL);
+    CHECK(paced.accepted * 100 >= (uint64_t)PUBLISH_TOTAL * MIN_ACCEPTED_PERCENT);
+
+    StressResult latency;
+    CHECK(RunPass(PASS_LATENCY, TORN_CAPACITY, &latency));
+    CHECK(latency.accepted == LATENCY_SAMPLES && latency.dropped == 0);
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("shm_stress: ok\n");
+    return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * Device slot map test against a reference model.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/slot_map.c -lm -o slot_map && ./slot_map
+ *
+ * Runs a long random sequence of inserts, removes and lookups over a pool
+ * of device IDs larger than the map, mirroring every operation in a plain
+ * array model. After each step the map must agree with the model on which
+ * devices are registered, which handle and context each one has, and the
+ * dense iteration order must cover exactly the live devices. Every handle
+ * ever issued is kept, so handles whose slot has since been reused by
+ * another device are checked to stay rejected.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DEVICE_IDS 160
+#define OPERATIONS 200000
+#define MAX_HANDLES (OPERATIONS + GYROSPACE_SLOTMAP_CAPACITY)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static uint64_t rngState = 0x853C49E6748FEA9Bull;
+
+static uint32_t Random(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (uint32_t)(rngState >> 33);
+}
+
+/** Reference model: per device ID, whether it is registered and its handle. */
+typedef struct {
+    uint64_t id[DEVICE_IDS];
+    bool live[DEVICE_IDS];
+    GyroSpaceDeviceHandle handle[DEVICE_IDS];
+    uint32_t count;
+} Model;
+
+/** Every handle the map has issued, and the device it was issued for. */
+static GyroSpaceDeviceHandle issued[MAX_HANDLES];
+static uint32_t issuedDevice[MAX_HANDLES];
+static uint32_t issuedCount = 0;
+
+static GyroSpaceSlotMap map;
+static Model model;
+
+/** Tags a context with its device so moves during removal can be tracked. */
+static void Tag(GyroSpaceContext* ctx, uint32_t device) {
+    ctx->angleX = (double)device;
+}
+
+static void Insert(uint32_t device) {
+    GyroSpaceDeviceHandle h = GyroSpace_SlotMapInsert(&map, model.id[device]);
+    if (model.live[device]) {
+        CHECK(h == model.handle[device]);
+        return;
+    }
+    if (model.count == GYROSPACE_SLOTMAP_CAPACITY) {
+        CHECK(h == GYROSPACE_INVALID_HANDLE);
+        return;
+    }
+    CHECK(h != GYROSPACE_INVALID_HANDLE);
+    if (h == GYROSPACE_INVALID_HANDLE)
+        return;
+    // A new handle never equals one issued before
+    for (uint32_t i = 0; i < issuedCount; ++i)
+        if (issued[i] == h) {
+            CHECK(issued[i] != h);
+            break;
+        }
+    GyroSpaceContext* ctx = GyroSpace_SlotMapGet(&map, h);
+    CHECK(ctx != NULL);
+    if (ctx != NULL)
+        Tag(ctx, device);
+    model.live[device] = true;
+    model.handle[device] = h;
+    model.count++;
+    issued[issuedCount] = h;
+    issuedDevice[issuedCount] = device;
+    issuedCount++;
+}
+
+static void Remove(uint32_t device, bool byId) {
+    bool removed = byId ? GyroSpace_SlotMapRemoveDevice(&map, model.id[device])
+                        : GyroSpace_SlotMapRemove(&map, model.handle[device]);
+    CHECK(removed == model.live[device]);
+    if (model.live[device]) {
+        model.live[device] = false;
+        model.count--;
+    }
+}
+
+/** Removing or resolving a random old handle must only work if it is still current. */
+static void ProbeOldHandle(void) {
+    if (issuedCount == 0)
+        return;
+    uint32_t i = Random() % issuedCount;
+    uint32_t device = issuedDevice[i];
+    bool current = model.live[device] && model.handle[device] == issued[i];
+    CHECK(GyroSpace_SlotMapIsValid(&map, issued[i]) == current);
+    CHECK((GyroSpace_SlotMapGet(&map, issued[i]) != NULL) == current);
+    if (!current)
+        CHECK(!GyroSpace_SlotMapRemove(&map, issued[i]));
+}
+
+static void CheckAgainstModel(void) {
+    CHECK(map.count == model.count);
+
+    for (uint32_t d = 0; d < DEVICE_IDS; ++d) {
+        GyroSpaceDeviceHandle h = GyroSpace_SlotMapFind(&map, model.id[d]);
+        if (!model.live[d]) {
+            CHECK(h == GYROSPACE_INVALID_HANDLE);
+            continue;
+        }
+        CHECK(h == model.handle[d]);
+        GyroSpaceContext* ctx = GyroSpace_SlotMapGet(&map, h);
+        CHECK(ctx != NULL && ctx->angleX == (double)d);
+    }
+
+    // Dense iteration visits each live device once, with a matching handle
+    static bool seen[DEVICE_IDS];
+    memset(seen, 0, sizeof(seen));
+    for (uint32_t i = 0; i < map.count; ++i) {
+        uint32_t d = (uint32_t)map.contexts[i].angleX;
+        CHECK(d < DEVICE_IDS);
+        if (d >= DEVICE_IDS)
+            continue;
+        CHECK(model.live[d] && !seen[d]);
+        CHECK(map.deviceIds[i] == model.id[d]);
+        CHECK(GyroSpace_SlotMapHandleAt(&map, i) == model.handle[d]);
+        seen[d] = true;
+    }
+}
+
+static void TestRandomOperations(void) {
+    GyroSpace_InitSlotMap(&map);
+    memset(&model, 0, sizeof(model));
+    // Spread-out 64-bit IDs plus a run of small consecutive ones
+    for (uint32_t d = 0; d < DEVICE_IDS; ++d) {
+        model.id[d] = (d < DEVICE_IDS / 2) ? ((uint64_t)Random() << 32 | Random()) : d;
+        model.handle[d] = GYROSPACE_INVALID_HANDLE;
+    }
+
+    for (uint32_t op = 0; op < OPERATIONS; ++op) {
+        uint32_t device = Random() % DEVICE_IDS;
+        uint32_t kind = Random() % 8;
+        // Alternate filling and draining phases so the map sweeps from empty to full
+        bool filling = (op / 4000) % 2 == 0;
+        uint32_t inserts = filling ? 4 : 1;
+        if (kind < inserts)
+            Insert(device);
+        else if (kind < 6)
+            Remove(device, kind % 2 == 1);
+        else
+            ProbeOldHandle();
+
+        if (op % 64 == 0 || model.count == GYROSPACE_SLOTMAP_CAPACITY)
+            CheckAgainstModel();
+    }
+    CheckAgainstModel();
+}
+
+static void TestStaleAfterReuse(void) {
+    GyroSpace_InitSlotMap(&map);
+    GyroSpaceDeviceHandle first = GyroSpace_SlotMapInsert(&map, 1001);
+    CHECK(GyroSpace_SlotMapRemove(&map, first));
+
+    // The freed slot is reused for the next device under a new generation
+    GyroSpaceDeviceHandle second = GyroSpace_SlotMapInsert(&map, 2002);
+    CHECK((second & 0xFFFFu) == (first & 0xFFFFu));
+    CHECK(second != first);
+    CHECK(!GyroSpace_SlotMapIsValid(&map, first));
+    CHECK(GyroSpace_SlotMapGet(&map, first) == NULL);
+    CHECK(!GyroSpace_SlotMapRemove(&map, first));
+    CHECK(GyroSpace_SlotMapFind(&map, 1001) == GYROSPACE_INVALID_HANDLE);
+    CHECK(GyroSpace_SlotMapFind(&map, 2002) == second);
+
+    // Reconnecting the first device gets a fresh handle, not the old one
+    GyroSpaceDeviceHandle again = GyroSpace_SlotMapInsert(&map, 1001);
+    CHECK(again != first && again != GYROSPACE_INVALID_HANDLE);
+    CHECK(!GyroSpace_SlotMapIsValid(&map, first));
+    CHECK(GyroSpace_SlotMapIsValid(&map, second));
+    CHECK(map.count == 2);
+}
+
+int main(void) {
+    TestStaleAfterReuse();
+    TestRandomOperations();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("slot_map: ok\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Tiered smoothing test against a recomputed-window reference.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/tiered_smoothing.c -lm -o tiered_smoothing && ./tiered_smoothing
+ *
+ * The reference is JoyShockMapper's tiered smoothing written the slow way:
+ * split each sample into direct and smoothed parts by speed, keep the last
+ * window of smoothed parts, and re-add all of them from scratch every
+ * sample in double precision. The running-sum smoother must
+ * track it over a million samples without drift, for several windows and
+ * threshold ranges, and the batch form must match the per-sample form.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLES 1000000
+#define TOLERANCE 1e-5        // Relative to the upper threshold
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static uint64_t rngState = 0x5DEECE66Dull;
+
+static float Noise(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (float)((double)(rngState >> 40) / (double)(1u << 23) - 1.0);
+}
+
+/** Aiming-like input in deg/s: small corrections, medium tracking, fast turns. */
+static Vector3 Input(int i) {
+    int phase = i % 3000;
+    float scale = phase < 2000 ? 2.0f : phase < 2700 ? 25.0f : 400.0f;
+    return Vec3_New(scale * Noise(), scale * Noise(), 0.3f * scale * Noise());
+}
+
+static void TestAgainstReference(uint32_t window, float lower, float upper) {
+    static double history[GYROSPACE_SMOOTHING_MAX_WINDOW][3];
+    memset(history, 0, sizeof(history));
+    GyroSpaceTieredSmoother s;
+    GyroSpace_InitTieredSmoother(&s, window, lower, upper);
+
+    double worst = 0.0;
+    rngState = 0x5DEECE66Dull + window;
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 in = Input(i);
+        Vector3 out = GyroSpace_TieredSmooth(&s, in);
+
+        const double x[3] = { in.x, in.y, in.z };
+        double speed = sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+        double w = (upper > lower) ? fmin(fmax((speed - lower) / (upper - lower), 0.0), 1.0) : (speed >= upper ? 1.0 : 0.0);
+        double expected[3];
+        for (int k = 0; k < 3; ++k) {
+            history[i % window][k] = x[k] * (1.0 - w);
+            double sum = 0.0;
+            for (uint32_t j = 0; j < window; ++j)
+                sum += history[j][k];
+            expected[k] = x[k] * w + sum / window;
+        }
+        const float y[3] = { out.x, out.y, out.z };
+        for (int k = 0; k < 3; ++k) {
+            double error = fabs(y[k] - expected[k]) / upper;
+            if (error > worst)
+                worst = error;
+        }
+    }
+    printf("window %2u, %g..%g: worst relative error %.3g\n", window, lower, upper, worst);
+    CHECK(worst < TOLERANCE);
+}
+
+static void TestBehaviour(void) {
+    GyroSpaceTieredSmoother s;
+
+    // Window is clamped to [1, GYROSPACE_SMOOTHING_MAX_WINDOW]
+    GyroSpace_InitTieredSmoother(&s, 0, 1.0f, 2.0f);
+    CHECK(s.window == 1);
+    GyroSpace_InitTieredSmoother(&s, 100000, 1.0f, 2.0f);
+    CHECK(s.window == GYROSPACE_SMOOTHING_MAX_WINDOW);
+
+    // Slow input is averaged: a single blip is spread over the window
+    GyroSpace_InitTieredSmoother(&s, 8, 10.0f, 20.0f);
+    Vector3 out = GyroSpace_TieredSmooth(&s, Vec3_New(4.0f, 0.0f, 0.0f));
+    CHECK(out.x == 0.5f);
+    for (int i = 0; i < 7; ++i)
+        out = GyroSpace_TieredSmooth(&s, Vec3_New(0.0f, 0.0f, 0.0f));
+    CHECK(out.x == 0.5f);
+    out = GyroSpace_TieredSmooth(&s, Vec3_New(0.0f, 0.0f, 0.0f));
+    CHECK(out.x == 0.0f);
+
+    // Fast input passes straight through
+    out = GyroSpace_TieredSmooth(&s, Vec3_New(0.0f, 30.0f, 0.0f));
+    CHECK(out.y == 30.0f);
+
+    // Equal thresholds are a hard switch
+    GyroSpace_InitTieredSmoother(&s, 4, 10.0f, 10.0f);
+    out = GyroSpace_TieredSmooth(&s, Vec3_New(9.0f, 0.0f, 0.0f));
+    CHECK(out.x == 2.25f);
+    GyroSpace_ResetTieredSmoother(&s);
+    out = GyroSpace_TieredSmooth(&s, Vec3_New(10.0f, 0.0f, 0.0f));
+    CHECK(out.x == 10.0f);
+}
+
+static void TestBatch(void) {
+    enum { N = 5000 };
+    static float x[N], y[N], z[N], ox[N], oy[N], oz[N];
+    for (int i = 0; i < N; ++i) {
+        Vector3 in = Input(i);
+        x[i] = in.x;
+        y[i] = in.y;
+        z[i] = in.z;
+    }
+    GyroSpaceTieredSmoother a, b;
+    GyroSpace_InitTieredSmoother(&a, 16, 5.0f, 50.0f);
+    GyroSpace_InitTieredSmoother(&b, 16, 5.0f, 50.0f);
+    GyroSpace_TieredSmoothBatch(&a, x, y, z, ox, oy, oz, N);
+    int mismatches = 0;
+    for (int i = 0; i < N; ++i) {
+        Vector3 out = GyroSpace_TieredSmooth(&b, Vec3_New(x[i], y[i], z[i]));
+        if (out.x != ox[i] || out.y != oy[i] || out.z != oz[i])
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void) {
+    TestBehaviour();
+    TestBatch();
+    TestAgainstReference(1, 5.0f, 50.0f);
+    TestAgainstReference(16, 5.0f, 50.0f);
+    TestAgainstReference(GYROSPACE_SMOOTHING_MAX_WINDOW, 10.0f, 300.0f);
+    TestAgainstReference(8, 20.0f, 20.0f);
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("tiered_smoothing: ok\n");
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * uinput mouse sink test: creates the virtual mouse, sends gyro motion and
+ * reads the REL_X/REL_Y events back from its evdev node.
+ *
+ * Build and run from the repository root (gnu mode, Linux only):
+ *
+ *   cc -O2 -I. tests/uinput_readback.c -lm -o uinput_readback && ./uinput_readback
+ *
+ * Needs write access to /dev/uinput and read access to /dev/input; the
+ * device part is skipped (and reported) when they are unavailable. The
+ * axis mapping checks always run.
+ */
+
+#include "GyroSpaceLinux.h"
+
+#include <dirent.h>
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static void TestAxisMapping(void) {
+    GyroSpaceMouseSink sink = { -1, 0.0f, 0.0f };
+
+    // Player Space: (yaw, pitch, roll)
+    GyroSpaceMouse_MoveFromGyro(&sink, GYROSPACE_SPACE_PLAYER, Vec3_New(100.0f, 50.0f, 7.0f), 0.01f, 2.0f);
+    CHECK(sink.accumX == 2.0f && sink.accumY == 1.0f);
+
+    // World Space: (pitch, yaw, roll); yaw must still drive x
+    sink.accumX = sink.accumY = 0.0f;
+    GyroSpaceMouse_MoveFromGyro(&sink, GYROSPACE_SPACE_WORLD, Vec3_New(50.0f, 100.0f, 7.0f), 0.01f, 2.0f);
+    CHECK(sink.accumX == 2.0f && sink.accumY == 1.0f);
+
+    sink.accumX = sink.accumY = 0.0f;
+    GyroSpaceMouse_MoveYawPitch(&sink, -100.0f, 25.0f, 0.01f, 2.0f);
+    CHECK(sink.accumX == -2.0f && sink.accumY == 0.5f);
+}
+
+/** Opens /dev/input/eventN for the uinput device's sysfs name. */
+static int OpenEventNode(const char* sysName) {
+    char path[300];
+    snprintf(path, sizeof(path), "/sys/devices/virtual/input/%s", sysName);
+    DIR* dir = opendir(path);
+    if (dir == NULL)
+        return -1;
+
+    int fd = -1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "event", 5) == 0) {
+            snprintf(path, sizeof(path), "/dev/input/%s", entry->d_name);
+            fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            break;
+        }
+    }
+    closedir(dir);
+    return fd;
+}
+
+/** Sums REL_X/REL_Y from the events queued on fd, waiting up to a second for the first. */
+static int ReadMotion(int fd, int32_t* x, int32_t* y) {
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 1000) <= 0)
+        return 0;
+
+    int reports = 0;
+    struct input_event events[64];
+    ssize_t bytes;
+    while ((bytes = read(fd, events, sizeof(events))) > 0) {
+        for (size_t i = 0; i < (size_t)bytes / sizeof(events[0]); ++i) {
+            if (events[i].type == EV_REL && events[i].code == REL_X)
+                *x += events[i].value;
+            else if (events[i].type == EV_REL && events[i].code == REL_Y)
+                *y += events[i].value;
+            else if (events[i].type == EV_SYN && events[i].code == SYN_REPORT)
+                reports++;
+        }
+    }
+    return reports;
+}
+
+static void TestReadback(void) {
+    GyroSpaceMouseSink sink;
+    if (!GyroSpaceMouse_Open(&sink, "GyroSpace test mouse")) {
+        printf("uinput_readback: /dev/uinput unavailable (%s), device test skipped\n", strerror(errno));
+        return;
+    }
+
+    char sysName[64];
+    int fd = -1;
+    // udev may take a moment to create the node
+    for (int attempt = 0; attempt < 50 && fd < 0; ++attempt) {
+        if (GyroSpaceMouse_GetSysName(&sink, sysName, sizeof(sysName)))
+            fd = OpenEventNode(sysName);
+        if (fd < 0)
+            usleep(20000);
+    }
+    if (fd < 0) {
+        printf("uinput_readback: event node not readable, device test skipped\n");
+        GyroSpaceMouse_Close(&sink);
+        return;
+    }
+
+    // 30 deg/s of World Space yaw at 1000 Hz and 10 counts per degree is
+    // 0.3 counts per sample: whole counts go out as the remainder builds up
+    int32_t x = 0, y = 0;
+    for (int i = 0; i < 100; ++i) {
+        GyroSpaceMouse_MoveFromGyro(&sink, GYROSPACE_SPACE_WORLD, Vec3_New(-20.0f, 30.0f, 0.0f), 0.001f, 10.0f);
+        CHECK(GyroSpaceMouse_Flush(&sink));
+    }
+    CHECK(ReadMotion(fd, &x, &y) > 0);
+    CHECK(x >= 29 && x <= 30);
+    CHECK(y >= -20 && y <= -19);
+    CHECK(fabsf(sink.accumX) < 1.0f && fabsf(sink.accumY) < 1.0f);
+
+    close(fd);
+    GyroSpaceMouse_Close(&sink);
+}
+
+int main(void) {
+    TestAxisMapping();
+    TestReadback();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("uinput_readback: ok\n");
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Mat3 and World Space test against the original per-sample formula.
+ *
+ * Build and run from the repository root:
+ *
+ *   cc -std=c99 -O2 -I. tests/world_space.c -lm -o world_space && ./world_space
+ *
+ * World Space used to be computed per sample by projecting the gyro vector
+ * onto the gravity, right and forward axes with dot products. It is now a
+ * cached Mat3. This test keeps the original formula as the reference and
+ * checks every World Space entry point against it for gravity directions
+ * over the whole sphere, including the ones near +-Z that take the X+
+ * fallback. It also checks the Mat3 helpers against a double-precision
+ * product and that the World Space matrix is a proper rotation.
+ */
+
+#include "GyroSpace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GRAVITY_POINTS 2000
+#define SAMPLES 37             // Per gravity direction; not a multiple of four
+#define TOLERANCE 2e-6         // Relative to the gyro magnitude
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static uint64_t rngState = 0x2545F4914F6CDD1Dull;
+
+/** Uniform in [-1, 1). */
+static float Random(void) {
+    rngState = rngState * 6364136223846793005ull + 1442695040888963407ull;
+    return (float)((double)(rngState >> 40) / (double)(1u << 23) - 1.0);
+}
+
+/** The World Space transform as originally written: dot products against the world axes. */
+static Vector3 ReferenceWorldSpace(Vector3 gravity, float yaw, float pitch, float roll) {
+    Vector3 gyro = Vec3_New(yaw, pitch, roll);
+    gravity = Vec3_Normalize(gravity);
+
+    Vector3 worldFwd = Vec3_New(0.0f, 0.0f, 1.0f);
+    if (fabsf(Vec3_Dot(gravity, worldFwd)) > 0.99f)
+        worldFwd = Vec3_New(1.0f, 0.0f, 0.0f);
+
+    Vector3 worldRight = Vec3_Normalize(Vec3_Cross(gravity, worldFwd));
+    Vector3 worldFwdProj = Vec3_Normalize(Vec3_Cross(worldRight, gravity));
+
+    return Vec3_New(Vec3_Dot(gyro, worldRight), Vec3_Dot(gyro, gravity), Vec3_Dot(gyro, worldFwdProj));
+}
+
+static double worstError = 0.0;
+
+static void Compare(Vector3 expected, float x, float y, float z, float magnitude) {
+    double scale = magnitude > 1.0f ? magnitude : 1.0;
+    double error = fmax(fabs((double)x - expected.x), fmax(fabs((double)y - expected.y), fabs((double)z - expected.z))) / scale;
+    if (error > worstError)
+        worstError = error;
+}
+
+/** Point i of n spread evenly over the unit sphere (Fibonacci lattice). */
+static Vector3 SpherePoint(int i, int n) {
+    double z = 1.0 - (2.0 * i + 1.0) / n;
+    double r = sqrt(1.0 - z * z);
+    double phi = i * 2.39996322972865332;
+    return Vec3_New((float)(r * cos(phi)), (float)(r * sin(phi)), (float)z);
+}
+
+static void CheckGravity(Vector3 accel) {
+    static float yaw[SAMPLES], pitch[SAMPLES], roll[SAMPLES], packed[SAMPLES][3];
+    static float outPitch[SAMPLES], outYaw[SAMPLES], outRoll[SAMPLES];
+    static Vector3A aligned[SAMPLES];
+
+    GyroSpaceContext ctx;
+    GyroSpace_InitContext(&ctx);
+    GyroSpace_SetGravityVector(&ctx, accel.x, accel.y, accel.z);
+    Vector3 gravity = GyroSpace_GetGravityVector(&ctx);
+    SetGravityVector(accel.x, accel.y, accel.z);
+    Vector3 globalGravity = GetGravityVector();
+
+    // The World Space matrix is a rotation whose second row is gravity
+    Mat3 w = GyroSpace_GetWorldMatrix(&ctx);
+    Mat3 wwt = Mat3_Multiply(w, Mat3_Transpose(w));
+    Mat3 id = Mat3_Identity();
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            CHECK(fabsf(wwt.m[r][c] - id.m[r][c]) < 1e-5f);
+    Vector3 r0 = Mat3_Row(&w, 0), r1 = Mat3_Row(&w, 1), r2 = Mat3_Row(&w, 2);
+    CHECK(fabsf(Vec3_Dot(r0, Vec3_Cross(r1, r2)) - 1.0f) < 1e-5f);
+    CHECK(fabsf(r1.x - gravity.x) < 1e-6f && fabsf(r1.y - gravity.y) < 1e-6f && fabsf(r1.z - gravity.z) < 1e-6f);
+
+    for (int i = 0; i < SAMPLES; ++i) {
+        float scale = (i % 3 == 0) ? 2000.0f : (i % 3 == 1) ? 1.0f : 0.01f;
+        yaw[i] = packed[i][0] = Random() * scale;
+        pitch[i] = packed[i][1] = Random() * scale;
+        roll[i] = packed[i][2] = Random() * scale;
+        aligned[i] = Vec3A_New(yaw[i], pitch[i], roll[i]);
+    }
+
+    for (int i = 0; i < SAMPLES; ++i) {
+        float magnitude = sqrtf(yaw[i] * yaw[i] + pitch[i] * pitch[i] + roll[i] * roll[i]);
+        Vector3 expected = ReferenceWorldSpace(gravity, yaw[i], pitch[i], roll[i]);
+
+        Vector3 v = GyroSpace_TransformToWorldSpace(&ctx, yaw[i], pitch[i], roll[i]);
+        Compare(expected, v.x, v.y, v.z, magnitude);
+
+        Vector3A a = GyroSpace_TransformToWorldSpaceA(&ctx, aligned[i]);
+        Compare(expected, a.x, a.y, a.z, magnitude);
+
+        v = TransformToWorldSpace(yaw[i], pitch[i], roll[i]);
+        Compare(ReferenceWorldSpace(globalGravity, yaw[i], pitch[i], roll[i]), v.x, v.y, v.z, magnitude);
+    }
+
+    GyroSpace_TransformToWorldSpaceBatch(&ctx, yaw, pitch, roll, outPitch, outYaw, outRoll, SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i)
+        Compare(ReferenceWorldSpace(gravity, yaw[i], pitch[i], roll[i]), outPitch[i], outYaw[i], outRoll[i],
+                sqrtf(yaw[i] * yaw[i] + pitch[i] * pitch[i] + roll[i] * roll[i]));
+
+    GyroSpace_TransformToWorldSpaceArrayBatch(&ctx, &packed[0][0], outPitch, outYaw, outRoll, SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i)
+        Compare(ReferenceWorldSpace(gravity, yaw[i], pitch[i], roll[i]), outPitch[i], outYaw[i], outRoll[i],
+                sqrtf(yaw[i] * yaw[i] + pitch[i] * pitch[i] + roll[i] * roll[i]));
+
+    Mat3_MulVec3ABatch(&w, aligned, aligned, SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i)
+        Compare(ReferenceWorldSpace(gravity, yaw[i], pitch[i], roll[i]), aligned[i].x, aligned[i].y, aligned[i].z,
+                sqrtf(yaw[i] * yaw[i] + pitch[i] * pitch[i] + roll[i] * roll[i]));
+
+    // Raw sensor reports: posture axis mapping, then World Space
+    GyroSpace_TransformSensorToWorldSpaceBatch(&ctx, &packed[0][0], outPitch, outYaw, outRoll, SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i) {
+        Vector3 mapped = GyroSpace_MapSensorAxes(&ctx, Vec3_New(packed[i][0], packed[i][1], packed[i][2]));
+        Compare(ReferenceWorldSpace(gravity, mapped.x, mapped.y, mapped.z), outPitch[i], outYaw[i], outRoll[i],
+                sqrtf(yaw[i] * yaw[i] + pitch[i] * pitch[i] + roll[i] * roll[i]));
+    }
+}
+
+static void TestWorldSpace(void) {
+    for (int i = 0; i < GRAVITY_POINTS; ++i)
+        CheckGravity(Vec3_Scale(SpherePoint(i, GRAVITY_POINTS), 1.0f + 0.1f * Random()));
+
+    // Either side of the X+ fallback threshold, and straight along Z
+    const float nearPole[] = { 0.98f, 0.9899f, 0.9901f, 0.995f, 1.0f };
+    for (size_t i = 0; i < sizeof(nearPole) / sizeof(nearPole[0]); ++i) {
+        float z = nearPole[i], r = sqrtf(1.0f - z * z);
+        CheckGravity(Vec3_New(r * 0.6f, r * 0.8f, z));
+        CheckGravity(Vec3_New(-r, 0.0f, -z));
+    }
+
+    printf("worst World Space error relative to gyro magnitude: %.3g\n", worstError);
+    CHECK(worstError < TOLERANCE);
+}
+
+static void TestMat3(void) {
+    for (int trial = 0; trial < 1000; ++trial) {
+        Mat3 a, b;
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c) {
+                a.m[r][c] = Random() * 4.0f;
+                b.m[r][c] = Random() * 4.0f;
+            }
+
+        Mat3 ab = Mat3_Multiply(a, b);
+        Mat3 t = Mat3_Transpose(a);
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                double sum = 0.0;
+                for (int k = 0; k < 3; ++k)
+                    sum += (double)a.m[r][k] * b.m[k][c];
+                CHECK(fabs(ab.m[r][c] - sum) < 1e-5);
+                CHECK(t.m[r][c] == a.m[c][r]);
+            }
+        }
+
+        // (a * b) v == a (b v)
+        Vector3 v = Vec3_New(Random(), Random(), Random());
+        Vector3 lhs = Mat3_MulVec3(&ab, v);
+        Vector3 bv = Mat3_MulVec3(&b, v);
+        Vector3 rhs = Mat3_MulVec3(&a, bv);
+        CHECK(fabsf(lhs.x - rhs.x) < 1e-4f && fabsf(lhs.y - rhs.y) < 1e-4f && fabsf(lhs.z - rhs.z) < 1e-4f);
+
+        Mat3 id = Mat3_Identity();
+        Mat3 ai = Mat3_Multiply(a, id);
+        CHECK(memcmp(&ai, &a, sizeof(Mat3)) == 0);
+        Mat3 rows = Mat3_FromRows(Mat3_Row(&a, 0), Mat3_Row(&a, 1), Mat3_Row(&a, 2));
+        CHECK(memcmp(&rows, &a, sizeof(Mat3)) == 0);
+    }
+}
+
+int main(void) {
+    TestMat3();
+    TestWorldSpace();
+
+    if (failures != 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("world_space: ok\n");
+    return 0;
+}